@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Аллокатор с выравниванием буферов на Alignment байт (например, на кеш-линию для SIMD).
+// Буферы от HugePageThreshold байт на Linux отображаются отдельно, выравниваются на
+// kHugePageSize и помечаются MADV_HUGEPAGE, чтобы ядро подложило прозрачные огромные страницы.
+template <typename T, size_t Alignment, size_t HugePageThreshold>
+class AlignedAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    static constexpr size_t kAlignment = std::max(Alignment, alignof(T));
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, HugePageThreshold>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, HugePageThreshold>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        const size_t bytes = n * sizeof(T);
+#ifdef __linux__
+        if (IsHuge(bytes)) {
+            return static_cast<T*>(MapHuge(bytes));
+        }
+#endif
+        return static_cast<T*>(operator new(bytes, std::align_val_t{kAlignment}));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+#ifdef __linux__
+        if (IsHuge(n * sizeof(T))) {
+            munmap(static_cast<void*>(p), RoundToHugePages(n * sizeof(T)));
+            return;
+        }
+#endif
+        operator delete(static_cast<void*>(p), std::align_val_t{kAlignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment, HugePageThreshold>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment, HugePageThreshold>&) const noexcept {
+        return false;
+    }
+
+private:
+#ifdef __linux__
+    static bool IsHuge(size_t bytes) noexcept {
+        return bytes >= HugePageThreshold;
+    }
+
+    static size_t RoundToHugePages(size_t bytes) noexcept {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+    // Отображает с запасом в одну огромную страницу и обрезает края, чтобы начало
+    // буфера совпало с границей огромной страницы
+    static void* MapHuge(size_t bytes) {
+        const size_t size = RoundToHugePages(bytes);
+        void* raw = mmap(nullptr, size + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        char* begin = static_cast<char*>(raw);
+        char* aligned = begin + (kHugePageSize - reinterpret_cast<uintptr_t>(begin) % kHugePageSize) % kHugePageSize;
+        if (aligned != begin) {
+            munmap(begin, aligned - begin);
+        }
+        const size_t tail = begin + size + kHugePageSize - (aligned + size);
+        if (tail != 0) {
+            munmap(aligned + size, tail);
+        }
+#ifdef MADV_HUGEPAGE
+        // Подсказка: при выключенных THP буфер остаётся на обычных страницах
+        madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+        return aligned;
+    }
+#endif
+};
+
+// Байтовый аллокатор для параметра Allocator: Vector<float, Aligned<64>> хранит
+// элементы в буфере, выровненном на 64 байта. HugePageThreshold = SIZE_MAX отключает огромные страницы.
+template <size_t Alignment, size_t HugePageThreshold = (size_t{2} << 20)>
+using Aligned = AlignedAllocator<std::byte, Alignment, HugePageThreshold>;
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Монотонная арена: память выделяется сдвигом указателя внутри цепочки блоков и
+// освобождается только целиком (Reset) или до отметки (Rewind). Не потокобезопасна.
+class Arena {
+public:
+    static constexpr size_t kDefaultChunkSize = size_t{64} << 10;
+
+    // Положение арены, к которому можно вернуться через Rewind
+    struct Mark {
+        void* chunk = nullptr;
+        char* cursor = nullptr;
+    };
+
+    explicit Arena(size_t chunk_size = kDefaultChunkSize) noexcept
+            : chunk_size_(chunk_size) {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        FreeChunksAfter(nullptr);
+    }
+
+    void* Allocate(size_t bytes, size_t alignment) {
+        char* p = AlignUp(cursor_, alignment);
+        if (head_ == nullptr || p > limit_ || static_cast<size_t>(limit_ - p) < bytes) {
+            AddChunk(bytes + alignment);
+            p = AlignUp(cursor_, alignment);
+        }
+        cursor_ = p + bytes;
+        return p;
+    }
+
+    // Удлиняет блок, если он выделен последним и в текущем блоке арены хватает места
+    bool Extend(void* p, size_t old_bytes, size_t new_bytes) noexcept {
+        char* block = static_cast<char*>(p);
+        if (block + old_bytes != cursor_ || new_bytes < old_bytes
+            || static_cast<size_t>(limit_ - cursor_) < new_bytes - old_bytes) {
+            return false;
+        }
+        cursor_ = block + new_bytes;
+        return true;
+    }
+
+    Mark GetMark() const noexcept {
+        return {head_, cursor_};
+    }
+
+    // Освобождает всё выделенное после отметки
+    void Rewind(const Mark& mark) noexcept {
+        if (mark.chunk == nullptr) {
+            Reset();
+            return;
+        }
+        FreeChunksAfter(static_cast<Chunk*>(mark.chunk));
+        cursor_ = mark.cursor;
+        limit_ = head_->Limit();
+    }
+
+    // Освобождает всё выделенное; первый блок остаётся для повторного использования
+    void Reset() noexcept {
+        if (head_ == nullptr) {
+            return;
+        }
+        Chunk* first = head_;
+        while (first->prev != nullptr) {
+            first = first->prev;
+        }
+        FreeChunksAfter(first);
+        cursor_ = first->Data();
+        limit_ = first->Limit();
+    }
+
+    size_t ChunkCount() const noexcept {
+        size_t count = 0;
+        for (Chunk* chunk = head_; chunk != nullptr; chunk = chunk->prev) {
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* prev;
+        size_t size;
+
+        char* Data() noexcept {
+            return reinterpret_cast<char*>(this + 1);
+        }
+
+        char* Limit() noexcept {
+            return Data() + size;
+        }
+    };
+
+    static char* AlignUp(char* p, size_t alignment) noexcept {
+        const auto address = reinterpret_cast<uintptr_t>(p);
+        return p + ((alignment - address % alignment) % alignment);
+    }
+
+    void AddChunk(size_t min_bytes) {
+        const size_t size = std::max(chunk_size_, min_bytes);
+        auto* chunk = static_cast<Chunk*>(operator new(sizeof(Chunk) + size));
+        chunk->prev = head_;
+        chunk->size = size;
+        head_ = chunk;
+        cursor_ = chunk->Data();
+        limit_ = chunk->Limit();
+    }
+
+    // Освобождает блоки, добавленные после last (nullptr — все блоки)
+    void FreeChunksAfter(Chunk* last) noexcept {
+        while (head_ != last) {
+            Chunk* prev = head_->prev;
+            operator delete(head_);
+            head_ = prev;
+        }
+        if (head_ == nullptr) {
+            cursor_ = nullptr;
+            limit_ = nullptr;
+        }
+    }
+
+    size_t chunk_size_;
+    Chunk* head_ = nullptr;
+    char* cursor_ = nullptr;
+    char* limit_ = nullptr;
+};
+
+// Возвращает арену к состоянию на момент создания при выходе из области видимости.
+// Векторы на этой арене должны быть разрушены раньше.
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) noexcept
+            : arena_(arena)
+            , mark_(arena.GetMark()) {
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope() {
+        arena_.Rewind(mark_);
+    }
+
+private:
+    Arena& arena_;
+    Arena::Mark mark_;
+};
+
+// Аллокатор для Vector поверх Arena: deallocate ничего не делает, а буфер,
+// выделенный последним, растёт на месте через expand_in_place
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& arena) noexcept
+            : arena_(&arena) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+            : arena_(other.GetArena()) {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {
+    }
+
+    bool expand_in_place(T* p, size_t old_n, size_t new_n) noexcept {
+        return arena_->Extend(p, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    Arena* GetArena() const noexcept {
+        return arena_;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.GetArena();
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ != other.GetArena();
+    }
+
+private:
+    Arena* arena_;
+};
\ No newline at end of file
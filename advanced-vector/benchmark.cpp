@@ -0,0 +1,255 @@
+// Сравнение Vector с std::vector на Google Benchmark.
+// Сборка: g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -lbenchmark -lpthread -o benchmark
+
+#include "vector.h"
+#include "test_objects.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Pod64 {
+        uint64_t fields[8];
+    };
+
+    template <typename T>
+    T MakeValue(size_t i) {
+        if constexpr (std::is_same_v<T, int>) {
+            return static_cast<int>(i);
+        } else if constexpr (std::is_same_v<T, Pod64>) {
+            return Pod64{{i, i, i, i, i, i, i, i}};
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            // Длиннее буфера SSO, чтобы копирование выделяло память
+            return std::string(32, static_cast<char>('a' + i % 26));
+        } else {
+            return Obj(static_cast<int>(i));
+        }
+    }
+
+    template <typename T>
+    uint64_t Key(const T& value) {
+        if constexpr (std::is_same_v<T, int>) {
+            return static_cast<uint64_t>(value);
+        } else if constexpr (std::is_same_v<T, Pod64>) {
+            return value.fields[0];
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return static_cast<uint64_t>(value[0]);
+        } else {
+            return static_cast<uint64_t>(value.id);
+        }
+    }
+
+    // Единый интерфейс к обоим контейнерам
+    template <typename T>
+    void Reserve(Vector<T>& v, size_t n) {
+        v.Reserve(n);
+    }
+    template <typename T>
+    void Reserve(std::vector<T>& v, size_t n) {
+        v.reserve(n);
+    }
+
+    template <typename T>
+    void PushBack(Vector<T>& v, const T& value) {
+        v.PushBack(value);
+    }
+    template <typename T>
+    void PushBack(std::vector<T>& v, const T& value) {
+        v.push_back(value);
+    }
+
+    template <typename T>
+    void EmplaceBack(Vector<T>& v, size_t i) {
+        v.EmplaceBack(MakeValue<T>(i));
+    }
+    template <typename T>
+    void EmplaceBack(std::vector<T>& v, size_t i) {
+        v.emplace_back(MakeValue<T>(i));
+    }
+
+    template <typename T>
+    void InsertMiddle(Vector<T>& v, const T& value) {
+        v.Insert(v.begin() + v.Size() / 2, value);
+    }
+    template <typename T>
+    void InsertMiddle(std::vector<T>& v, const T& value) {
+        v.insert(v.begin() + v.size() / 2, value);
+    }
+
+    template <typename T>
+    void EraseMiddle(Vector<T>& v) {
+        v.Erase(v.begin() + v.Size() / 2);
+    }
+    template <typename T>
+    void EraseMiddle(std::vector<T>& v) {
+        v.erase(v.begin() + v.size() / 2);
+    }
+
+    template <typename T>
+    void Resize(Vector<T>& v, size_t n) {
+        v.Resize(n);
+    }
+    template <typename T>
+    void Resize(std::vector<T>& v, size_t n) {
+        v.resize(n);
+    }
+
+    // Vector копирует в уже выделенный буфер через CopyVector, std::vector — присваиванием
+    template <typename T>
+    void CopyInto(Vector<T>& dst, const Vector<T>& src) {
+        dst.CopyVector(src);
+    }
+    template <typename T>
+    void CopyInto(std::vector<T>& dst, const std::vector<T>& src) {
+        dst = src;
+    }
+
+    template <typename Container>
+    Container MakeFilled(size_t n) {
+        using T = typename Container::value_type;
+        Container v;
+        Reserve(v, n);
+        for (size_t i = 0; i < n; ++i) {
+            PushBack(v, MakeValue<T>(i));
+        }
+        return v;
+    }
+
+    template <typename Container>
+    void BM_PushBack(benchmark::State& state) {
+        using T = typename Container::value_type;
+        const size_t n = static_cast<size_t>(state.range(0));
+        const T value = MakeValue<T>(1);
+        for (auto _ : state) {
+            Container v;
+            for (size_t i = 0; i < n; ++i) {
+                PushBack(v, value);
+            }
+            benchmark::DoNotOptimize(v);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Container>
+    void BM_PushBackReserved(benchmark::State& state) {
+        using T = typename Container::value_type;
+        const size_t n = static_cast<size_t>(state.range(0));
+        const T value = MakeValue<T>(1);
+        for (auto _ : state) {
+            Container v;
+            Reserve(v, n);
+            for (size_t i = 0; i < n; ++i) {
+                PushBack(v, value);
+            }
+            benchmark::DoNotOptimize(v);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Container>
+    void BM_EmplaceBack(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        for (auto _ : state) {
+            Container v;
+            for (size_t i = 0; i < n; ++i) {
+                EmplaceBack(v, i);
+            }
+            benchmark::DoNotOptimize(v);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Container>
+    void BM_EmplaceBackReserved(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        for (auto _ : state) {
+            Container v;
+            Reserve(v, n);
+            for (size_t i = 0; i < n; ++i) {
+                EmplaceBack(v, i);
+            }
+            benchmark::DoNotOptimize(v);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Вставка и удаление в середине вектора размера range(0); пара операций сохраняет размер
+    template <typename Container>
+    void BM_InsertEraseMiddle(benchmark::State& state) {
+        using T = typename Container::value_type;
+        Container v = MakeFilled<Container>(static_cast<size_t>(state.range(0)));
+        Reserve(v, static_cast<size_t>(state.range(0)) + 1);
+        const T value = MakeValue<T>(7);
+        for (auto _ : state) {
+            InsertMiddle(v, value);
+            EraseMiddle(v);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * 2);
+    }
+
+    template <typename Container>
+    void BM_CopyAssign(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const Container src = MakeFilled<Container>(n);
+        Container dst = MakeFilled<Container>(n);
+        for (auto _ : state) {
+            CopyInto(dst, src);
+            benchmark::DoNotOptimize(dst);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Рост до range(0) элементов и обратно
+    template <typename Container>
+    void BM_Resize(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        for (auto _ : state) {
+            Container v;
+            Resize(v, n);
+            benchmark::DoNotOptimize(v);
+            Resize(v, n / 2);
+            benchmark::DoNotOptimize(v);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Container>
+    void BM_Iterate(benchmark::State& state) {
+        const Container v = MakeFilled<Container>(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            uint64_t sum = 0;
+            for (const auto& value : v) {
+                sum += Key(value);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+}  // namespace
+
+#define VECTOR_BENCHMARK(NAME, TYPE, FROM, TO) \
+    BENCHMARK_TEMPLATE(NAME, Vector<TYPE>)->RangeMultiplier(16)->Range(FROM, TO); \
+    BENCHMARK_TEMPLATE(NAME, std::vector<TYPE>)->RangeMultiplier(16)->Range(FROM, TO)
+
+#define VECTOR_BENCHMARK_ALL_TYPES(NAME, FROM, TO) \
+    VECTOR_BENCHMARK(NAME, int, FROM, TO); \
+    VECTOR_BENCHMARK(NAME, Pod64, FROM, TO); \
+    VECTOR_BENCHMARK(NAME, std::string, FROM, TO); \
+    VECTOR_BENCHMARK(NAME, Obj, FROM, TO)
+
+VECTOR_BENCHMARK_ALL_TYPES(BM_PushBack, 16, 1 << 16);
+VECTOR_BENCHMARK_ALL_TYPES(BM_PushBackReserved, 16, 1 << 16);
+VECTOR_BENCHMARK_ALL_TYPES(BM_EmplaceBack, 16, 1 << 16);
+VECTOR_BENCHMARK_ALL_TYPES(BM_EmplaceBackReserved, 16, 1 << 16);
+VECTOR_BENCHMARK_ALL_TYPES(BM_InsertEraseMiddle, 16, 1 << 16);
+VECTOR_BENCHMARK_ALL_TYPES(BM_CopyAssign, 16, 1 << 16);
+VECTOR_BENCHMARK_ALL_TYPES(BM_Resize, 16, 1 << 16);
+VECTOR_BENCHMARK_ALL_TYPES(BM_Iterate, 16, 1 << 16);
+
+BENCHMARK_MAIN();
\ No newline at end of file
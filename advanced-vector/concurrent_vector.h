@@ -0,0 +1,206 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+// Вектор только для дописывания из многих потоков.
+// Элементы живут в сегментах удваивающегося размера (kFirstSegmentSize, 2 * kFirstSegmentSize, ...),
+// которые никогда не перемещаются, поэтому ссылки на элементы стабильны и перевыделений нет.
+// PushBack/EmplaceBack резервируют индекс атомарным счётчиком без блокировок; сегмент выделяет
+// поток, получивший его первый индекс, а остальные писатели сегмента ждут его публикации,
+// так что при одновременном переходе границы сегмент выделяется и размечается один раз.
+// За элементами сегмента лежат флаги готовности, по которым TryGet без ожидания отличает
+// созданные элементы от зарезервированных. Аллокатор должен допускать вызовы из разных потоков.
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentVector {
+public:
+    using value_type = T;
+    using allocator_type = typename RawMemory<T, Allocator>::allocator_type;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    static constexpr size_t kFirstSegmentLog = 5;
+    static constexpr size_t kFirstSegmentSize = size_t{1} << kFirstSegmentLog;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const allocator_type& alloc) noexcept
+            : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector& other) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector& rhs) = delete;
+
+    ~ConcurrentVector() {
+        const size_t size = size_.load(std::memory_order_acquire);
+        for (size_t segment = 0; segment < kMaxSegments; ++segment) {
+            T* elements = segments_[segment].load(std::memory_order_acquire);
+            if (elements == nullptr) {
+                continue;
+            }
+            const size_t first = SegmentBegin(segment);
+            const size_t count = SegmentSize(segment);
+            const std::atomic<uint8_t>* ready = ReadyFlags(elements, count);
+            for (size_t i = 0; i < count && first + i < size; ++i) {
+                if (ready[i].load(std::memory_order_relaxed) != 0) {
+                    alloc_traits::destroy(alloc_, elements + i);
+                }
+            }
+            RawMemory<T, allocator_type> memory(alloc_);
+            memory.Adopt(elements, SegmentCapacity(segment));
+        }
+    }
+
+    template <typename Obj>
+    void PushBack(Obj&& obj) {
+        EmplaceBack(std::forward<Obj>(obj));
+    }
+
+    // Если конструктор бросил, индекс остаётся зарезервированным, а элемент — несозданным
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        const size_t segment = SegmentOf(index);
+        const size_t offset = index - SegmentBegin(segment);
+        T* elements = AcquireSegment(segment, offset == 0);
+        alloc_traits::construct(alloc_, elements + offset, std::forward<Args>(args)...);
+        ReadyFlags(elements, SegmentSize(segment))[offset].store(1, std::memory_order_release);
+        return elements[offset];
+    }
+
+    // Выделяет сегменты под первые capacity элементов заранее. С владельцем сегмента
+    // Reserve может столкнуться лишь один раз на сегмент: проигравший освободит свой буфер
+    void Reserve(size_t capacity) {
+        for (size_t segment = 0; segment < kMaxSegments && SegmentBegin(segment) < capacity; ++segment) {
+            if (segments_[segment].load(std::memory_order_acquire) == nullptr) {
+                PublishSegment(segment);
+            }
+        }
+    }
+
+    // Число зарезервированных индексов, включая элементы, которые ещё создаются
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Элемент по индексу, если он уже создан, иначе nullptr; не ждёт и не блокирует
+    const T* TryGet(size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this).TryGet(index);
+    }
+
+    T* TryGet(size_t index) noexcept {
+        if (index >= Size()) {
+            return nullptr;
+        }
+        const size_t segment = SegmentOf(index);
+        T* elements = segments_[segment].load(std::memory_order_acquire);
+        if (elements == nullptr) {
+            return nullptr;
+        }
+        const size_t offset = index - SegmentBegin(segment);
+        const bool ready = ReadyFlags(elements, SegmentSize(segment))[offset].load(std::memory_order_acquire) != 0;
+        return ready ? elements + offset : nullptr;
+    }
+
+    // Элемент должен быть создан и виден вызывающему потоку (например, после join писателей)
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        const size_t segment = SegmentOf(index);
+        T* elements = segments_[segment].load(std::memory_order_acquire);
+        assert(elements != nullptr);
+        return elements[index - SegmentBegin(segment)];
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    // Сегменты, размер которых в байтах не переполняет size_t
+    static constexpr size_t kMaxSegments = sizeof(size_t) * 8 - kFirstSegmentLog - 8;
+
+    // Сегмент k содержит индексы [kFirstSegmentSize * (2^k - 1), kFirstSegmentSize * (2^(k+1) - 1))
+    static size_t SegmentOf(size_t index) noexcept {
+        const size_t shifted = (index >> kFirstSegmentLog) + 1;
+#if defined(__GNUC__)
+        return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(shifted));
+#else
+        size_t segment = 0;
+        while (shifted >> (segment + 1) != 0) {
+            ++segment;
+        }
+        return segment;
+#endif
+    }
+
+    static constexpr size_t SegmentBegin(size_t segment) noexcept {
+        return kFirstSegmentSize * ((size_t{1} << segment) - 1);
+    }
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+
+    // Элементы и следом однобайтовые флаги готовности, в единицах T
+    static constexpr size_t SegmentCapacity(size_t segment) noexcept {
+        return SegmentSize(segment) + (SegmentSize(segment) + sizeof(T) - 1) / sizeof(T);
+    }
+
+    static std::atomic<uint8_t>* ReadyFlags(T* elements, size_t count) noexcept {
+        return reinterpret_cast<std::atomic<uint8_t>*>(elements + count);
+    }
+
+    // Сегмент выделяет только владелец его первого индекса; остальные уступают процессор,
+    // пока сегмент не появится. Если владелец не смог выделить память, сегмент выделяют сами
+    T* AcquireSegment(size_t segment, bool owner) {
+        if (segment >= kMaxSegments) {
+            throw std::length_error("ConcurrentVector is too long");
+        }
+        T* elements = segments_[segment].load(std::memory_order_acquire);
+        if (elements != nullptr) {
+            return elements;
+        }
+        if (owner) {
+            try {
+                return PublishSegment(segment);
+            } catch (...) {
+                orphaned_[segment].store(true, std::memory_order_release);
+                throw;
+            }
+        }
+        while ((elements = segments_[segment].load(std::memory_order_acquire)) == nullptr) {
+            if (orphaned_[segment].load(std::memory_order_acquire)) {
+                return PublishSegment(segment);
+            }
+            std::this_thread::yield();
+        }
+        return elements;
+    }
+
+    T* PublishSegment(size_t segment) {
+        T* elements = nullptr;
+        RawMemory<T, allocator_type> memory(SegmentCapacity(segment), alloc_);
+        std::atomic<uint8_t>* ready = ReadyFlags(memory.GetAddress(), SegmentSize(segment));
+        for (size_t i = 0; i < SegmentSize(segment); ++i) {
+            new (ready + i) std::atomic<uint8_t>(0);
+        }
+        if (segments_[segment].compare_exchange_strong(elements, memory.GetAddress(), std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            return memory.Release();
+        }
+        // Сегмент уже установил другой поток; memory освободит свой буфер
+        return elements;
+    }
+
+    allocator_type alloc_;
+    std::atomic<size_t> size_{0};
+    std::atomic<T*> segments_[kMaxSegments] = {};
+    std::atomic<bool> orphaned_[kMaxSegments] = {};
+};
\ No newline at end of file
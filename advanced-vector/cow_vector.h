@@ -0,0 +1,267 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+
+// Вектор с копированием при записи: копии делят один неизменяемый блок с атомарным
+// счётчиком ссылок, поэтому снимок стоит O(1) и не выделяет память. Первое изменение
+// через неконстантный доступ (operator[], begin, PushBack, Emplace, ...) копирует блок,
+// если им владеет кто-то ещё; константные операции никогда не копируют.
+// Как и shared_ptr, разные объекты CowVector можно копировать и менять из разных потоков,
+// даже если они делят блок; один объект без синхронизации менять можно только из одного потока.
+// Ссылки и итераторы, полученные из разделяемого вектора, становятся недействительными
+// при его первом изменении. Для чтения без копирования удобны cbegin/cend и std::as_const.
+template <typename T, typename Allocator = std::allocator<T>>
+class CowVector {
+public:
+    using vector_type = Vector<T, Allocator>;
+    using value_type = T;
+    using allocator_type = typename vector_type::allocator_type;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    CowVector() = default;
+
+    explicit CowVector(const allocator_type& alloc) noexcept
+            : alloc_(alloc) {
+    }
+
+    // Забирает элементы vector без копирования
+    explicit CowVector(vector_type&& vector)
+            : alloc_(vector.GetAllocator())
+            , block_(NewBlock(std::move(vector))) {
+    }
+
+    CowVector(const CowVector& other) noexcept
+            : alloc_(other.alloc_)
+            , block_(other.block_) {
+        if (block_ != nullptr) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+            : alloc_(other.alloc_)
+            , block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        CowVector copy(rhs);
+        Swap(copy);
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Unref(std::exchange(block_, std::exchange(rhs.block_, nullptr)));
+            alloc_ = rhs.alloc_;
+        }
+        return *this;
+    }
+
+    ~CowVector() {
+        Unref(block_);
+    }
+
+    void Swap(CowVector& other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        std::swap(block_, other.block_);
+    }
+
+    size_t Size() const noexcept {
+        return block_ != nullptr ? block_->data.Size() : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return block_ != nullptr ? block_->data.Capacity() : 0;
+    }
+
+    // Число CowVector, делящих блок (0 у пустого вектора без блока)
+    size_t UseCount() const noexcept {
+        return block_ != nullptr ? block_->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    bool IsShared() const noexcept {
+        return UseCount() > 1;
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    const_iterator begin() const noexcept {
+        return block_ != nullptr ? block_->data.begin() : nullptr;
+    }
+    const_iterator end() const noexcept {
+        return block_ != nullptr ? block_->data.end() : nullptr;
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Неконстантные итераторы отделяют вектор от копий
+    iterator begin() {
+        return Mutable().begin();
+    }
+    iterator end() {
+        return Mutable().end();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return block_->data[index];
+    }
+
+    T& operator[](size_t index) {
+        assert(index < Size());
+        return Mutable()[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity() || IsShared()) {
+            Mutate(new_capacity, [new_capacity](vector_type& data) {
+                data.Reserve(new_capacity);
+            });
+        }
+    }
+
+    void Resize(size_t new_size) {
+        Mutate(new_size, [new_size](vector_type& data) {
+            data.Resize(new_size);
+        });
+    }
+
+    // Отказывается от блока без копирования, если его делят другие
+    void Clear() noexcept {
+        if (IsShared()) {
+            Unref(std::exchange(block_, nullptr));
+        } else if (block_ != nullptr) {
+            block_->data.Clear();
+        }
+    }
+
+    template <typename Obj>
+    void PushBack(Obj&& obj) {
+        EmplaceBack(std::forward<Obj>(obj));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return Mutate(Size() + 1, [&](vector_type& data) -> T& {
+            return data.EmplaceBack(std::forward<Args>(args)...);
+        });
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t position = pos - cbegin();
+        return Mutate(Size() + 1, [&](vector_type& data) {
+            return data.Emplace(data.cbegin() + position, std::forward<Args>(args)...);
+        });
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    void PopBack() {
+        assert(Size() > 0);
+        Mutate(Size(), [](vector_type& data) {
+            data.PopBack();
+        });
+    }
+
+    iterator Erase(const_iterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        return Erase(pos, pos + 1);
+    }
+
+    iterator Erase(const_iterator first, const_iterator last) {
+        assert(first >= cbegin() && first <= last && last <= cend());
+        const size_t position = first - cbegin();
+        const size_t count = last - first;
+        return Mutate(Size(), [position, count](vector_type& data) {
+            return data.Erase(data.cbegin() + position, data.cbegin() + position + count);
+        });
+    }
+
+private:
+    struct Block {
+        template <typename... Args>
+        explicit Block(Args&&... args)
+                : data(std::forward<Args>(args)...) {
+        }
+
+        std::atomic<size_t> refs{1};
+        vector_type data;
+    };
+
+    using block_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<Block>;
+    using block_traits = std::allocator_traits<block_allocator>;
+
+    allocator_type alloc_;
+    Block* block_ = nullptr;
+
+    template <typename... Args>
+    Block* NewBlock(Args&&... args) {
+        block_allocator alloc(alloc_);
+        Block* block = block_traits::allocate(alloc, 1);
+        try {
+            block_traits::construct(alloc, block, std::forward<Args>(args)...);
+        } catch (...) {
+            block_traits::deallocate(alloc, block, 1);
+            throw;
+        }
+        return block;
+    }
+
+    // Последний владелец разрушает блок; acquire видит все записи прежних владельцев
+    void Unref(Block* block) noexcept {
+        if (block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            block_allocator alloc(alloc_);
+            block_traits::destroy(alloc, block);
+            block_traits::deallocate(alloc, block, 1);
+        }
+    }
+
+    vector_type& Mutable() {
+        return Mutate(Size(), [](vector_type& data) -> vector_type& {
+            return data;
+        });
+    }
+
+    // Применяет change к собственному блоку. Разделяемый блок сначала копируется
+    // с ёмкостью не меньше capacity, и change применяется к копии до отказа от старого блока:
+    // аргументы change могут ссылаться на его элементы. При исключении вектор не меняется.
+    template <typename Change>
+    decltype(auto) Mutate(size_t capacity, Change&& change) {
+        if (block_ == nullptr) {
+            block_ = NewBlock(alloc_);
+        } else if (block_->refs.load(std::memory_order_acquire) != 1) {
+            vector_type copy(alloc_);
+            copy.Reserve(std::max(capacity, Size()));
+            copy.Append(block_->data.begin(), block_->data.end());
+            CowVector fresh(std::move(copy));
+            if constexpr (std::is_void_v<decltype(change(fresh.block_->data))>) {
+                change(fresh.block_->data);
+                Swap(fresh);
+                return;
+            } else {
+                decltype(auto) result = change(fresh.block_->data);
+                Swap(fresh);
+                return result;
+            }
+        }
+        return change(block_->data);
+    }
+};
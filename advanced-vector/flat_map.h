@@ -0,0 +1,623 @@
+#pragma once
+
+#include "vector.h"
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace detail {
+
+// Индекс первого элемента [data, data + n), для которого pred ложен (все истинные идут раньше).
+// Длина шага не зависит от данных, а выбор половины сводится к условной пересылке,
+// поэтому поиск не страдает от неверно предсказанных переходов
+template <typename K, typename Pred>
+size_t BranchlessPartitionPoint(const K* data, size_t n, Pred pred) {
+    if (n == 0) {
+        return 0;
+    }
+    const K* base = data;
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = pred(base[half]) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - data) + pred(*base);
+}
+
+// Хвост [sorted, n), добавленный к упорядоченным уникальным [0, sorted), уже стоит на месте
+template <typename K, typename Compare>
+bool TailIsInOrder(const K* keys, size_t sorted, size_t n, const Compare& comp) {
+    for (size_t i = std::max<size_t>(sorted, 1); i < n; ++i) {
+        if (!comp(keys[i - 1], keys[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Порядок элементов после слияния упорядоченных уникальных [0, sorted) с хвостом [sorted, n):
+// хвост устойчиво сортируется по индексам, и из равных ключей остаётся самый левый
+template <typename K, typename Compare>
+Vector<size_t> MergedOrder(const K* keys, size_t sorted, size_t n, const Compare& comp) {
+    Vector<size_t> tail;
+    tail.Reserve(n - sorted);
+    for (size_t i = sorted; i < n; ++i) {
+        tail.PushBack(i);
+    }
+    std::stable_sort(tail.Data(), tail.Data() + tail.Size(), [keys, &comp](size_t lhs, size_t rhs) {
+        return comp(keys[lhs], keys[rhs]);
+    });
+
+    Vector<size_t> order;
+    order.Reserve(n);
+    auto emit = [&](size_t index) {
+        if (order.Size() == 0 || comp(keys[order[order.Size() - 1]], keys[index])) {
+            order.PushBack(index);
+        }
+    };
+    size_t i = 0;
+    for (size_t index : tail) {
+        while (i < sorted && !comp(keys[index], keys[i])) {
+            emit(i++);
+        }
+        emit(index);
+    }
+    while (i < sorted) {
+        emit(i++);
+    }
+    return order;
+}
+
+// Переносит в пустой зарезервированный result элементы source в порядке order.
+// Бросающие перемещения заменяются копированием, так что при исключении source не меняется.
+// С kMayMove == false копируются и элементы с небросающим перемещением: так вызывающий
+// сохраняет source целым, если исключение возникнет позже, в другом массиве
+template <bool kMayMove, typename Container>
+void Gather(Container& source, const Vector<size_t>& order, Container& result) {
+    using T = typename Container::value_type;
+    for (size_t index : order) {
+        if constexpr (kMayMove || !std::is_copy_constructible_v<T>) {
+            result.EmplaceBack(std::move_if_noexcept(source.Data()[index]));
+        } else {
+            result.EmplaceBack(std::as_const(source.Data()[index]));
+        }
+    }
+}
+
+}  // namespace detail
+
+// Множество на упорядоченном Vector без повторов: поиск — двоичный без ветвлений,
+// обход — по непрерывному буферу. Вставка одного элемента сдвигает хвост, поэтому
+// наборы элементов выгоднее добавлять через InsertRange, а готовый буфер — через Replace.
+// Ключи изменять нельзя: итераторы только константные.
+template <typename K, typename Compare = std::less<K>, typename Container = Vector<K>>
+class FlatSet {
+public:
+    using key_type = K;
+    using value_type = K;
+    using key_compare = Compare;
+    using container_type = Container;
+    using iterator = typename Container::const_iterator;
+    using const_iterator = typename Container::const_iterator;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+            : comp_(comp) {
+    }
+
+    // Упорядочивает keys и убирает повторы (остаётся первый из равных)
+    explicit FlatSet(Container keys, const Compare& comp = Compare())
+            : keys_(std::move(keys))
+            , comp_(comp) {
+        SortTail(0);
+    }
+
+    const_iterator begin() const noexcept {
+        return keys_.begin();
+    }
+    const_iterator end() const noexcept {
+        return keys_.end();
+    }
+    const_iterator cbegin() const noexcept {
+        return keys_.cbegin();
+    }
+    const_iterator cend() const noexcept {
+        return keys_.cend();
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    size_t Capacity() const noexcept {
+        return keys_.Capacity();
+    }
+
+    const Container& Keys() const noexcept {
+        return keys_;
+    }
+
+    key_compare KeyComp() const {
+        return comp_;
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    const_iterator LowerBound(const K& key) const {
+        return cbegin() + LowerIndex(key);
+    }
+
+    const_iterator UpperBound(const K& key) const {
+        return cbegin() + detail::BranchlessPartitionPoint(keys_.Data(), Size(), [&](const K& x) {
+            return !comp_(key, x);
+        });
+    }
+
+    const_iterator Find(const K& key) const {
+        const size_t index = LowerIndex(key);
+        return index != Size() && !comp_(key, keys_[index]) ? cbegin() + index : cend();
+    }
+
+    bool Contains(const K& key) const {
+        return Find(key) != cend();
+    }
+
+    std::pair<iterator, bool> Insert(const K& key) {
+        return Emplace(key);
+    }
+
+    std::pair<iterator, bool> Insert(K&& key) {
+        return Emplace(std::move(key));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> Emplace(Args&&... args) {
+        K key(std::forward<Args>(args)...);
+        const size_t index = LowerIndex(key);
+        if (index != Size() && !comp_(key, keys_[index])) {
+            return {cbegin() + index, false};
+        }
+        keys_.Emplace(keys_.cbegin() + index, std::move(key));
+        return {cbegin() + index, true};
+    }
+
+    // Дописывает [first, last) в конец, сортирует дописанное и сливает с имеющимся
+    // за O(n log n) вместо сдвига хвоста на каждый элемент. Из равных ключей остаётся
+    // уже имевшийся либо первый в диапазоне. Строгая гарантия исключений.
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last) {
+        const size_t old_size = Size();
+        try {
+            keys_.Append(first, last);
+            SortTail(old_size);
+        } catch (...) {
+            keys_.Erase(keys_.cbegin() + std::min(old_size, Size()), keys_.cend());
+            throw;
+        }
+    }
+
+    iterator Erase(const_iterator pos) {
+        return keys_.Erase(pos);
+    }
+
+    size_t Erase(const K& key) {
+        const const_iterator pos = Find(key);
+        if (pos == cend()) {
+            return 0;
+        }
+        Erase(pos);
+        return 1;
+    }
+
+    // Отдаёт буфер без копирования; множество остаётся пустым
+    Container Extract() noexcept {
+        Container keys = std::move(keys_);
+        keys_.Clear();
+        return keys;
+    }
+
+    // Забирает буфер, уже упорядоченный по KeyComp() и без повторов
+    void Replace(Container&& keys) noexcept {
+        assert(detail::TailIsInOrder(keys.Data(), 0, keys.Size(), comp_));
+        keys_ = std::move(keys);
+    }
+
+private:
+    Container keys_;
+    [[no_unique_address]] Compare comp_;
+
+    size_t LowerIndex(const K& key) const {
+        return detail::BranchlessPartitionPoint(keys_.Data(), Size(), [&](const K& x) {
+            return comp_(x, key);
+        });
+    }
+
+    void SortTail(size_t sorted) {
+        if (detail::TailIsInOrder(keys_.Data(), sorted, Size(), comp_)) {
+            return;
+        }
+        const Vector<size_t> order = detail::MergedOrder(keys_.Data(), sorted, Size(), comp_);
+        Container keys(keys_.GetAllocator());
+        keys.Reserve(order.Size());
+        detail::Gather<true>(keys_, order, keys);
+        keys_.Swap(keys);
+    }
+};
+
+// Отображение на двух упорядоченных Vector: ключи лежат отдельно от значений,
+// поэтому поиск читает только плотный массив ключей. Элементы при обходе —
+// пары ссылок std::pair<const K&, V&>. Остальное — как у FlatSet.
+template <typename K, typename V, typename Compare = std::less<K>, typename KeyContainer = Vector<K>,
+          typename MappedContainer = Vector<V>>
+class FlatMap {
+    template <bool kConst>
+    class PairIterator;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = Compare;
+    using reference = std::pair<const K&, V&>;
+    using const_reference = std::pair<const K&, const V&>;
+    using key_container_type = KeyContainer;
+    using mapped_container_type = MappedContainer;
+    using iterator = PairIterator<false>;
+    using const_iterator = PairIterator<true>;
+
+    // Буферы ключей и значений для Extract/Replace
+    struct Containers {
+        KeyContainer keys;
+        MappedContainer values;
+    };
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+            : comp_(comp) {
+    }
+
+    // Упорядочивает пары (keys[i], values[i]) по ключу и убирает повторы (остаётся первая из равных)
+    FlatMap(KeyContainer keys, MappedContainer values, const Compare& comp = Compare())
+            : keys_(std::move(keys))
+            , values_(std::move(values))
+            , comp_(comp) {
+        assert(keys_.Size() == values_.Size());
+        SortTail(0);
+    }
+
+    iterator begin() noexcept {
+        return iterator(keys_.Data(), values_.Data());
+    }
+    iterator end() noexcept {
+        return begin() + Size();
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(keys_.Data(), values_.Data());
+    }
+    const_iterator end() const noexcept {
+        return begin() + Size();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    size_t Capacity() const noexcept {
+        return std::min(keys_.Capacity(), values_.Capacity());
+    }
+
+    const KeyContainer& Keys() const noexcept {
+        return keys_;
+    }
+
+    const MappedContainer& Values() const noexcept {
+        return values_;
+    }
+
+    key_compare KeyComp() const {
+        return comp_;
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+        values_.Reserve(new_capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    iterator LowerBound(const K& key) {
+        return begin() + LowerIndex(key);
+    }
+
+    const_iterator LowerBound(const K& key) const {
+        return begin() + LowerIndex(key);
+    }
+
+    iterator UpperBound(const K& key) {
+        return begin() + UpperIndex(key);
+    }
+
+    const_iterator UpperBound(const K& key) const {
+        return begin() + UpperIndex(key);
+    }
+
+    iterator Find(const K& key) {
+        return begin() + FindIndex(key);
+    }
+
+    const_iterator Find(const K& key) const {
+        return begin() + FindIndex(key);
+    }
+
+    bool Contains(const K& key) const {
+        return FindIndex(key) != Size();
+    }
+
+    V& At(const K& key) {
+        const size_t index = FindIndex(key);
+        if (index == Size()) {
+            throw std::out_of_range("FlatMap::At: key not found");
+        }
+        return values_[index];
+    }
+
+    const V& At(const K& key) const {
+        return const_cast<FlatMap&>(*this).At(key);
+    }
+
+    V& operator[](const K& key) {
+        return (*TryEmplace(key).first).second;
+    }
+
+    V& operator[](K&& key) {
+        return (*TryEmplace(std::move(key)).first).second;
+    }
+
+    std::pair<iterator, bool> Insert(const value_type& value) {
+        return TryEmplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> Insert(value_type&& value) {
+        return TryEmplace(std::move(value.first), std::move(value.second));
+    }
+
+    // Значение создаётся из args, только если ключа ещё нет. Строгая гарантия исключений
+    template <typename Key, typename... Args>
+    std::pair<iterator, bool> TryEmplace(Key&& key, Args&&... args) {
+        const size_t index = LowerIndex(key);
+        if (index != Size() && !comp_(key, keys_[index])) {
+            return {begin() + index, false};
+        }
+        values_.Emplace(values_.cbegin() + index, std::forward<Args>(args)...);
+        try {
+            keys_.Emplace(keys_.cbegin() + index, std::forward<Key>(key));
+        } catch (...) {
+            values_.Erase(values_.cbegin() + index);
+            throw;
+        }
+        return {begin() + index, true};
+    }
+
+    // Дописывает пары [first, last) (с полями first и second) в конец, сортирует дописанное
+    // и сливает с имеющимся за O(n log n). Из равных ключей остаётся уже имевшийся
+    // либо первый в диапазоне. Строгая гарантия исключений.
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last) {
+        const size_t old_size = Size();
+        try {
+            for (; first != last; ++first) {
+                keys_.EmplaceBack((*first).first);
+                values_.EmplaceBack((*first).second);
+            }
+            SortTail(old_size);
+        } catch (...) {
+            keys_.Erase(keys_.cbegin() + std::min(old_size, keys_.Size()), keys_.cend());
+            values_.Erase(values_.cbegin() + std::min(old_size, values_.Size()), values_.cend());
+            throw;
+        }
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t index = pos - cbegin();
+        assert(index < Size());
+        keys_.Erase(keys_.cbegin() + index);
+        values_.Erase(values_.cbegin() + index);
+        return begin() + index;
+    }
+
+    size_t Erase(const K& key) {
+        const size_t index = FindIndex(key);
+        if (index == Size()) {
+            return 0;
+        }
+        Erase(cbegin() + index);
+        return 1;
+    }
+
+    // Отдаёт буферы без копирования; отображение остаётся пустым
+    Containers Extract() noexcept {
+        Containers result{std::move(keys_), std::move(values_)};
+        Clear();
+        return result;
+    }
+
+    // Забирает буферы одного размера; ключи уже упорядочены по KeyComp() и без повторов
+    void Replace(KeyContainer&& keys, MappedContainer&& values) noexcept {
+        assert(keys.Size() == values.Size());
+        assert(detail::TailIsInOrder(keys.Data(), 0, keys.Size(), comp_));
+        keys_ = std::move(keys);
+        values_ = std::move(values);
+    }
+
+private:
+    KeyContainer keys_;
+    MappedContainer values_;
+    [[no_unique_address]] Compare comp_;
+
+    template <typename Key>
+    size_t LowerIndex(const Key& key) const {
+        return detail::BranchlessPartitionPoint(keys_.Data(), Size(), [&](const K& x) {
+            return comp_(x, key);
+        });
+    }
+
+    size_t UpperIndex(const K& key) const {
+        return detail::BranchlessPartitionPoint(keys_.Data(), Size(), [&](const K& x) {
+            return !comp_(key, x);
+        });
+    }
+
+    // Индекс ключа или Size()
+    size_t FindIndex(const K& key) const {
+        const size_t index = LowerIndex(key);
+        return index != Size() && !comp_(key, keys_[index]) ? index : Size();
+    }
+
+    // Буферы для обоих массивов выделяются до первого переноса, а перемещаются массивы,
+    // только если ни ключи, ни значения не бросают при перемещении. Иначе оба копируются,
+    // и исключение (из выделения или копирования) оставляет keys_ и values_ нетронутыми
+    void SortTail(size_t sorted) {
+        if (detail::TailIsInOrder(keys_.Data(), sorted, Size(), comp_)) {
+            return;
+        }
+        const Vector<size_t> order = detail::MergedOrder(keys_.Data(), sorted, Size(), comp_);
+        KeyContainer keys(keys_.GetAllocator());
+        MappedContainer values(values_.GetAllocator());
+        keys.Reserve(order.Size());
+        values.Reserve(order.Size());
+        constexpr bool kMayMove = std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>;
+        detail::Gather<kMayMove>(keys_, order, keys);
+        detail::Gather<kMayMove>(values_, order, values);
+        keys_.Swap(keys);
+        values_.Swap(values);
+    }
+
+    template <bool kConst>
+    class PairIterator {
+        using Value = std::conditional_t<kConst, const V, V>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = FlatMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, Value&>;
+        using pointer = void;
+
+        PairIterator() = default;
+
+        PairIterator(const K* key, Value* value) noexcept
+                : key_(key)
+                , value_(value) {
+        }
+
+        // iterator приводится к const_iterator
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        PairIterator(const PairIterator<kOtherConst>& other) noexcept
+                : key_(other.key_)
+                , value_(other.value_) {
+        }
+
+        reference operator*() const noexcept {
+            return reference(*key_, *value_);
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        PairIterator& operator++() noexcept {
+            return *this += 1;
+        }
+
+        PairIterator operator++(int) noexcept {
+            PairIterator old = *this;
+            *this += 1;
+            return old;
+        }
+
+        PairIterator& operator--() noexcept {
+            return *this -= 1;
+        }
+
+        PairIterator operator--(int) noexcept {
+            PairIterator old = *this;
+            *this -= 1;
+            return old;
+        }
+
+        PairIterator& operator+=(difference_type offset) noexcept {
+            key_ += offset;
+            value_ += offset;
+            return *this;
+        }
+
+        PairIterator& operator-=(difference_type offset) noexcept {
+            return *this += -offset;
+        }
+
+        friend PairIterator operator+(PairIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend PairIterator operator+(difference_type offset, PairIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend PairIterator operator-(PairIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const PairIterator& lhs, const PairIterator& rhs) noexcept {
+            return lhs.key_ - rhs.key_;
+        }
+
+        friend bool operator==(const PairIterator& lhs, const PairIterator& rhs) noexcept {
+            return lhs.key_ == rhs.key_;
+        }
+
+        friend bool operator!=(const PairIterator& lhs, const PairIterator& rhs) noexcept {
+            return lhs.key_ != rhs.key_;
+        }
+
+        friend bool operator<(const PairIterator& lhs, const PairIterator& rhs) noexcept {
+            return lhs.key_ < rhs.key_;
+        }
+
+        friend bool operator<=(const PairIterator& lhs, const PairIterator& rhs) noexcept {
+            return lhs.key_ <= rhs.key_;
+        }
+
+        friend bool operator>(const PairIterator& lhs, const PairIterator& rhs) noexcept {
+            return lhs.key_ > rhs.key_;
+        }
+
+        friend bool operator>=(const PairIterator& lhs, const PairIterator& rhs) noexcept {
+            return lhs.key_ >= rhs.key_;
+        }
+
+    private:
+        template <bool>
+        friend class PairIterator;
+
+        const K* key_ = nullptr;
+        Value* value_ = nullptr;
+    };
+};
@@ -0,0 +1,417 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+
+// Вектор с постепенным перевыделением. При росте выделяется новый буфер, но старые
+// элементы переносятся в него не сразу, а по MigrationStep за каждый следующий
+// PushBack/EmplaceBack/PopBack, поэтому ни одна вставка не стоит O(n): большой буфер
+// не копируется целиком внутри одного вызова. Пока идёт перенос, элемент i лежит в новом
+// буфере, если уже перенесён или добавлен после начала роста, иначе — в старом;
+// operator[] выбирает буфер одним сравнением. С DoublingGrowth и MigrationStep >= 1
+// перенос заканчивается раньше, чем заполнится новый буфер.
+// Перенос перемещает элементы, поэтому ссылки и указатели на них действительны только
+// до следующей изменяющей операции, а непрерывного буфера (Data) во время переноса нет.
+template <typename T, size_t MigrationStep = 2, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DoublingGrowth>
+class IncrementalVector {
+    static_assert(MigrationStep > 0, "MigrationStep must be positive");
+
+    template <bool kConst>
+    class IndexIterator;
+
+public:
+    using value_type = T;
+    using allocator_type = typename RawMemory<T, Allocator>::allocator_type;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+    using iterator = IndexIterator<false>;
+    using const_iterator = IndexIterator<true>;
+
+    static constexpr size_t kMigrationStep = MigrationStep;
+
+    IncrementalVector() = default;
+
+    explicit IncrementalVector(const allocator_type& alloc) noexcept
+            : data_(alloc)
+            , old_(alloc) {
+    }
+
+    IncrementalVector(const IncrementalVector& other)
+            : IncrementalVector(alloc_traits::select_on_container_copy_construction(other.data_.GetAllocator())) {
+        Reserve(other.size_);
+        for (const T& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    IncrementalVector(IncrementalVector&& other) noexcept
+            : data_(std::move(other.data_))
+            , old_(std::move(other.old_))
+            , size_(std::exchange(other.size_, 0))
+            , old_size_(std::exchange(other.old_size_, 0))
+            , migrated_(std::exchange(other.migrated_, 0)) {
+    }
+
+    IncrementalVector& operator=(const IncrementalVector& rhs) {
+        if (this != &rhs) {
+            IncrementalVector copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    IncrementalVector& operator=(IncrementalVector&& rhs) noexcept {
+        if (this != &rhs) {
+            IncrementalVector moved(std::move(rhs));
+            Swap(moved);
+        }
+        return *this;
+    }
+
+    ~IncrementalVector() {
+        Clear();
+    }
+
+    void Swap(IncrementalVector& other) noexcept {
+        data_.Swap(other.data_);
+        old_.Swap(other.old_);
+        std::swap(size_, other.size_);
+        std::swap(old_size_, other.old_size_);
+        std::swap(migrated_, other.migrated_);
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Ёмкость нового буфера; старый во время переноса сюда не входит
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Идёт ли перенос из старого буфера
+    bool IsMigrating() const noexcept {
+        return migrated_ != old_size_;
+    }
+
+    // Число элементов, ещё лежащих в старом буфере
+    size_t PendingMigration() const noexcept {
+        return old_size_ - migrated_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<IncrementalVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    // Переносит до count элементов, например в простое между запросами
+    void AdvanceMigration(size_t count) {
+        const size_t last = std::min(old_size_, migrated_ + count);
+        for (; migrated_ < last; ++migrated_) {
+            RelocateOne(old_.GetAddress() + migrated_, data_.GetAddress() + migrated_);
+        }
+        if (migrated_ == old_size_) {
+            ReleaseOld();
+        }
+    }
+
+    // Заканчивает перенос за O(оставшихся элементов)
+    void FinishMigration() {
+        AdvanceMigration(PendingMigration());
+    }
+
+    // Перевыделяет сразу, без постепенного переноса: Reserve вызывают заранее,
+    // когда за задержку ещё можно заплатить
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+        FinishMigration();
+        RawMemory<T, allocator_type> new_data(new_capacity, data_.GetAllocator());
+        if constexpr (kRelocateBitwise) {
+            if (size_ != 0) {
+                std::memcpy(static_cast<void*>(new_data.GetAddress()), static_cast<const void*>(data_.GetAddress()),
+                            size_ * sizeof(T));
+            }
+        } else {
+            size_t i = 0;
+            try {
+                for (; i < size_; ++i) {
+                    alloc_traits::construct(data_.GetAllocator(), new_data.GetAddress() + i,
+                                            std::move_if_noexcept(data_.GetAddress()[i]));
+                }
+            } catch (...) {
+                // Бросить могло только копирование, и исходные элементы целы
+                DestroyN(new_data.GetAddress(), i);
+                throw;
+            }
+            DestroyN(data_.GetAddress(), size_);
+        }
+        data_.Swap(new_data);
+    }
+
+    void Clear() noexcept {
+        while (size_ > 0) {
+            PopLast();
+        }
+        ReleaseOld();
+    }
+
+    template <typename Obj>
+    void PushBack(Obj&& obj) {
+        EmplaceBack(std::forward<Obj>(obj));
+    }
+
+    // Шаг переноса делается до вставки, поэтому при исключении содержимое вектора не меняется.
+    // Аргументы могут ссылаться на элементы: шаг переноса переместил бы их или освободил
+    // старый буфер, поэтому в таком случае элемент сначала строится во временном объекте
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if ((IsMigrating() || size_ == data_.Capacity()) && AliasesElements(args...)) {
+            T value(std::forward<Args>(args)...);
+            return EmplaceBack(std::move(value));
+        }
+        if (IsMigrating()) {
+            AdvanceMigration(kMigrationStep);
+        }
+        if (size_ == data_.Capacity()) {
+            // Перенос успевает закончиться, если GrowthPolicy растит ёмкость хотя бы
+            // в 1 + 1 / MigrationStep раза; иначе остаток переносится здесь же
+            FinishMigration();
+            StartMigration(GrowthPolicy::NextCapacity(data_.Capacity(), size_ + 1, sizeof(T)));
+        }
+        T* slot = data_.GetAddress() + size_;
+        alloc_traits::construct(data_.GetAllocator(), slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PopBack() {
+        assert(size_ > 0);
+        if (IsMigrating()) {
+            AdvanceMigration(kMigrationStep);
+        }
+        PopLast();
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+private:
+    // Элементы [0, migrated_) и [old_size_, size_) лежат в data_, а [migrated_, old_size_) — в old_
+    RawMemory<T, allocator_type> data_;
+    RawMemory<T, allocator_type> old_;
+    size_t size_ = 0;
+    size_t old_size_ = 0;
+    size_t migrated_ = 0;
+
+    static constexpr bool kRelocateBitwise = is_trivially_relocatable_v<T>
+                                             && detail::kUsesDefaultConstruct<allocator_type, T>;
+
+    // Ссылается ли хоть один аргумент на элемент в любом из буферов
+    template <typename... Args>
+    bool AliasesElements(const Args&... args) const noexcept {
+        [[maybe_unused]] auto in = [](const void* p, const T* first, size_t count) {
+            return std::less_equal<const void*>()(first, p) && std::less<const void*>()(p, first + count);
+        };
+        return (... || (in(std::addressof(args), data_.GetAddress(), data_.Capacity())
+                        || in(std::addressof(args), old_.GetAddress(), old_size_)));
+    }
+
+    T* Slot(size_t index) noexcept {
+        return index - migrated_ < old_size_ - migrated_ ? old_.GetAddress() + index : data_.GetAddress() + index;
+    }
+
+    // Новый буфер берёт на себя все будущие вставки; старые элементы переезжают постепенно
+    void StartMigration(size_t new_capacity) {
+        assert(!IsMigrating() && old_.GetAddress() == nullptr);
+        RawMemory<T, allocator_type> new_data(new_capacity, data_.GetAllocator());
+        old_.Swap(data_);
+        data_.Swap(new_data);
+        old_size_ = size_;
+        migrated_ = 0;
+        if (old_size_ == 0) {
+            ReleaseOld();
+        }
+    }
+
+    void ReleaseOld() noexcept {
+        old_ = RawMemory<T, allocator_type>(data_.GetAllocator());
+        old_size_ = 0;
+        migrated_ = 0;
+    }
+
+    // Перемещение, если оно не бросает (или копирование невозможно), иначе копирование:
+    // при исключении элемент остаётся на старом месте
+    void RelocateOne(T* src, T* dst) {
+        if constexpr (kRelocateBitwise) {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(T));
+        } else {
+            alloc_traits::construct(data_.GetAllocator(), dst, std::move_if_noexcept(*src));
+            alloc_traits::destroy(data_.GetAllocator(), src);
+        }
+    }
+
+    void DestroyN(T* data, size_t n) noexcept {
+        for (size_t i = 0; i < n; ++i) {
+            alloc_traits::destroy(data_.GetAllocator(), data + i);
+        }
+    }
+
+    void PopLast() noexcept {
+        alloc_traits::destroy(data_.GetAllocator(), Slot(size_ - 1));
+        --size_;
+        if (size_ < old_size_) {
+            // Удалён ещё не перенесённый элемент: старая часть сокращается
+            old_size_ = size_;
+            if (migrated_ >= old_size_) {
+                ReleaseOld();
+            }
+        }
+    }
+
+    template <bool kConst>
+    class IndexIterator {
+        using Owner = std::conditional_t<kConst, const IncrementalVector, IncrementalVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<kConst, const T*, T*>;
+        using reference = std::conditional_t<kConst, const T&, T&>;
+
+        IndexIterator() = default;
+
+        IndexIterator(Owner* owner, size_t index) noexcept
+                : owner_(owner)
+                , index_(index) {
+        }
+
+        // iterator приводится к const_iterator
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        IndexIterator(const IndexIterator<kOtherConst>& other) noexcept
+                : owner_(other.owner_)
+                , index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        IndexIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        IndexIterator operator++(int) noexcept {
+            IndexIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        IndexIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        IndexIterator operator--(int) noexcept {
+            IndexIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        IndexIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        IndexIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend IndexIterator operator+(IndexIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend IndexIterator operator+(difference_type offset, IndexIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend IndexIterator operator-(IndexIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator<=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator>=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        template <bool>
+        friend class IndexIterator;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+};
@@ -1,105 +1,370 @@
 #include "vector.h"
+#include "aligned_allocator.h"
+#include "arena_allocator.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "incremental_vector.h"
+#include "malloc_allocator.h"
+#include "mapped_vector.h"
+#include "persistent_vector.h"
+#include "pool_allocator.h"
+#include "segmented_vector.h"
+#include "small_vector.h"
+#include "static_vector.h"
+#include "soa_vector.h"
+#include "test_objects.h"
+#include "vector_algorithms.h"
+#include "vector_serialization.h"
+#include "vector_stats.h"
+#include "vector_trace.h"
 
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 namespace {
 
-// "Магическое" число, используемое для отслеживания живости объекта
-    inline const uint32_t DEFAULT_COOKIE = 0xdeadbeef;
+    // Аллокатор с состоянием: считает выделения и сравнивается по идентификатору арены
+    template <typename T>
+    struct TrackingAllocator {
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::false_type;
 
-    struct TestObj {
-        TestObj() = default;
-        TestObj(const TestObj& other) = default;
-        TestObj& operator=(const TestObj& other) = default;
-        TestObj(TestObj&& other) = default;
-        TestObj& operator=(TestObj&& other) = default;
-        ~TestObj() {
-            cookie = 0;
+        explicit TrackingAllocator(int id, int* allocations) noexcept
+                : id(id)
+                , allocations(allocations) {
         }
-        [[nodiscard]] bool IsAlive() const noexcept {
-            return cookie == DEFAULT_COOKIE;
+
+        template <typename U>
+        TrackingAllocator(const TrackingAllocator<U>& other) noexcept
+                : id(other.id)
+                , allocations(other.allocations) {
         }
-        uint32_t cookie = DEFAULT_COOKIE;
-    };
 
-    struct Obj {
-        Obj() {
-            if (default_construction_throw_countdown > 0) {
-                if (--default_construction_throw_countdown == 0) {
-                    throw std::runtime_error("Oops");
-                }
-            }
-            ++num_default_constructed;
+        T* allocate(size_t n) {
+            ++*allocations;
+            return static_cast<T*>(operator new(n * sizeof(T)));
         }
 
-        explicit Obj(int id)
-                : id(id)  //
-        {
-            ++num_constructed_with_id;
+        void deallocate(T* p, size_t) noexcept {
+            --*allocations;
+            operator delete(p);
         }
 
-        Obj(int id, std::string name)
-                : id(id)
-                , name(std::move(name))  //
-        {
-            ++num_constructed_with_id_and_name;
+        template <typename U>
+        bool operator==(const TrackingAllocator<U>& other) const noexcept {
+            return id == other.id;
         }
 
-        Obj(const Obj& other)
-                : id(other.id)  //
-        {
-            if (other.throw_on_copy) {
+        template <typename U>
+        bool operator!=(const TrackingAllocator<U>& other) const noexcept {
+            return id != other.id;
+        }
+
+        int id = 0;
+        int* allocations = nullptr;
+    };
+
+    // Тип с нетривиальными перемещением и деструктором, явно объявленный побайтово переносимым
+    struct RelocatableObj {
+        explicit RelocatableObj(int id)
+                : id(id) {
+        }
+        RelocatableObj(const RelocatableObj& other)
+                : id(other.id) {
+            ++num_copied;
+        }
+        RelocatableObj(RelocatableObj&& other) noexcept
+                : id(other.id) {
+            ++num_moved;
+        }
+        RelocatableObj& operator=(const RelocatableObj& other) = default;
+        RelocatableObj& operator=(RelocatableObj&& other) = default;
+        ~RelocatableObj() {
+            ++num_destroyed;
+        }
+
+        int id = 0;
+
+        static inline int num_copied = 0;
+        static inline int num_moved = 0;
+        static inline int num_destroyed = 0;
+    };
+
+    // Элемент для параллельного создания: счётчики атомарны, создание может бросить
+    struct ConcurrentObj {
+        ConcurrentObj() {
+            if (construction_throw_countdown.fetch_sub(1) == 1) {
                 throw std::runtime_error("Oops");
             }
-            ++num_copied;
+            ++num_alive;
+        }
+        ConcurrentObj(const ConcurrentObj& other)
+                : id(other.id) {
+            ++num_alive;
+        }
+        ConcurrentObj& operator=(const ConcurrentObj& other) = default;
+        ~ConcurrentObj() {
+            --num_alive;
         }
 
-        Obj(Obj&& other) noexcept
-                : id(other.id)  //
-        {
-            ++num_moved;
+        int id = 1;
+
+        static inline std::atomic<int> construction_throw_countdown{0};
+        static inline std::atomic<int> num_alive{0};
+    };
+
+    // Только копируемый тип: перемещение копирует и потому может бросить
+    struct CopyOnlyObj {
+        explicit CopyOnlyObj(int id)
+                : id(id) {
+        }
+        CopyOnlyObj(const CopyOnlyObj& other)
+                : id(other.id) {
+            if (copy_throw_countdown > 0 && --copy_throw_countdown == 0) {
+                throw std::runtime_error("Oops");
+            }
         }
+        CopyOnlyObj& operator=(const CopyOnlyObj& other) = default;
 
-        Obj& operator=(const Obj& other) = default;
-        Obj& operator=(Obj&& other) = default;
+        int id = 0;
 
-        ~Obj() {
-            ++num_destroyed;
-            id = 0;
+        static inline int copy_throw_countdown = 0;
+    };
+
+    // Потокобезопасно считает выделения (общий счётчик на каждый T) и выделяет медленно,
+    // чтобы гонки за выделение успевали случиться
+    template <typename T>
+    struct CountingAllocator {
+        using value_type = T;
+
+        CountingAllocator() = default;
+
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>&) noexcept {
         }
 
-        static int GetAliveObjectCount() {
-            return num_default_constructed + num_copied + num_moved + num_constructed_with_id
-                   + num_constructed_with_id_and_name - num_destroyed;
+        T* allocate(size_t n) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return std::allocator<T>().allocate(n);
         }
 
-        static void ResetCounters() {
-            default_construction_throw_countdown = 0;
-            num_default_constructed = 0;
-            num_copied = 0;
-            num_moved = 0;
-            num_destroyed = 0;
-            num_constructed_with_id = 0;
-            num_constructed_with_id_and_name = 0;
+        void deallocate(T* p, size_t n) noexcept {
+            std::allocator<T>().deallocate(p, n);
         }
 
-        bool throw_on_copy = false;
-        int id = 0;
-        std::string name;
+        template <typename U>
+        bool operator==(const CountingAllocator<U>&) const noexcept {
+            return true;
+        }
 
-        static inline int default_construction_throw_countdown = 0;
-        static inline int num_default_constructed = 0;
-        static inline int num_constructed_with_id = 0;
-        static inline int num_constructed_with_id_and_name = 0;
-        static inline int num_copied = 0;
-        static inline int num_moved = 0;
-        static inline int num_destroyed = 0;
+        template <typename U>
+        bool operator!=(const CountingAllocator<U>&) const noexcept {
+            return false;
+        }
+
+        static inline std::atomic<int> allocations{0};
+    };
+
+    struct OrdersStatsTag {
+        static constexpr const char* kName = "orders";
+    };
+
+    struct Entry {
+        int key;
+        char tag;
+    };
+
+    // Таблица, построенная при компиляции
+    constexpr StaticVector<Entry, 16> MakeTable() {
+        StaticVector<Entry, 16> table;
+        for (int i = 0; i < 10; ++i) {
+            table.EmplaceBack(i * i, static_cast<char>('a' + i));
+        }
+        table.Erase(table.begin() + 1, table.begin() + 3);
+        table.Emplace(table.begin(), -1, 'z');
+        table.PopBack();
+        if (!table.TryPushBack(Entry{100, 'q'})) {
+            table.Clear();
+        }
+        while (table.TryEmplaceBack(0, '-') != nullptr) {
+        }
+        return table;
+    }
+
+    // Обобщённый код над StaticVector одинаков для тривиальных и нетривиальных T
+    template <typename V, typename Make>
+    void CheckStaticVectorSurface(Make make) {
+        static_assert(V::kCapacity == 8);
+        V v(2, parallel);
+        v.Reserve(8);
+        assert(v.Size() == 2 && v.Data() == &v[0] && v[1] == make(0));
+        v[0] = make(1);
+        v.Insert(v.cend(), 2, make(2));
+        v.Insert(v.cbegin() + 1, 1, v[0]);
+        const std::vector<typename V::value_type> more{make(3), make(4)};
+        v.Append(more.begin(), more.begin() + 1);
+        v.Insert(v.cbegin(), more.begin(), more.begin() + 1);
+        using InputIt = std::istream_iterator<typename V::value_type>;
+        std::stringstream single_pass;
+        single_pass << make(5);
+        v.Insert(v.cbegin() + 1, InputIt(single_pass), InputIt());
+        assert(v.Size() == 8 && v[0] == make(3) && v[1] == make(5) && v[2] == make(1) && v[3] == make(1));
+        assert(v[4] == make(0) && v[5] == make(2) && v[7] == make(3));
+        try {
+            v.Insert(v.cbegin(), 1, make(9));
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            std::stringstream overflow;
+            overflow << make(6) << ' ' << make(7);
+            v.Resize(7);
+            v.Append(InputIt(overflow), InputIt());
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        // Как и в Vector, дописанное до переполнения остаётся в конце
+        assert(v.Size() == 8 && v[6] == make(2) && v[7] == make(6));
+
+        V other(1, parallel);
+        v.Swap(other);
+        assert(v.Size() == 1 && other.Size() == 8 && other[0] == make(3));
+        v.ShrinkToFit();
+        v.AppendDefault(2);
+        assert(v.Size() == 3 && v.Capacity() == 8 && v[2] == make(0));
+        V copy(other, parallel);
+        copy.Resize(2, parallel);
+        copy.ClearAndRelease();
+        assert(copy.Size() == 0 && other.GetAllocator() == copy.GetAllocator());
+    }
+
+    // Выполняет одну и ту же случайную последовательность операций над StaticVector и Vector
+    template <typename T, typename Make>
+    void CheckStaticVectorMatchesVector(Make make) {
+        constexpr size_t N = 32;
+        StaticVector<T, N> sv;
+        Vector<T> v;
+        uint32_t state = 12345;
+        auto next = [&state](size_t bound) {
+            state = state * 1664525 + 1013904223;
+            return static_cast<size_t>(state >> 8) % bound;
+        };
+        for (int step = 0; step < 3000; ++step) {
+            const size_t size = v.Size();
+            const size_t pos = next(size + 1);
+            const size_t count = next(4);
+            const T value = make(static_cast<int>(next(100)));
+            switch (next(10)) {
+                case 0:
+                    if (size < N) {
+                        sv.PushBack(value);
+                        v.PushBack(value);
+                    }
+                    break;
+                case 1:
+                    if (size < N) {
+                        sv.Emplace(sv.cbegin() + pos, value);
+                        v.Emplace(v.cbegin() + pos, value);
+                    }
+                    break;
+                case 2:
+                    if (size + count <= N) {
+                        sv.Insert(sv.cbegin() + pos, count, value);
+                        v.Insert(v.cbegin() + pos, count, value);
+                    }
+                    break;
+                case 3:
+                    if (size + count <= N) {
+                        const std::vector<T> items(count, value);
+                        sv.Insert(sv.cbegin() + pos, items.begin(), items.end());
+                        v.Insert(v.cbegin() + pos, items.begin(), items.end());
+                    }
+                    break;
+                case 4:
+                    if (pos < size) {
+                        sv.Erase(sv.cbegin() + pos);
+                        v.Erase(v.cbegin() + pos);
+                    }
+                    break;
+                case 5: {
+                    const size_t last = pos + next(size - pos + 1);
+                    sv.Erase(sv.cbegin() + pos, sv.cbegin() + last);
+                    v.Erase(v.cbegin() + pos, v.cbegin() + last);
+                    break;
+                }
+                case 6:
+                    sv.PopBack();
+                    v.PopBack();
+                    break;
+                case 7: {
+                    const size_t new_size = next(N + 1);
+                    sv.Resize(new_size);
+                    v.Resize(new_size);
+                    break;
+                }
+                case 8:
+                    if (size + count <= N) {
+                        sv.AppendDefault(count);
+                        v.AppendDefault(count);
+                    }
+                    break;
+                default: {
+                    StaticVector<T, N> copy(sv);
+                    copy.Swap(sv);
+                    sv = copy;
+                    break;
+                }
+            }
+            assert(sv.Size() == v.Size());
+            for (size_t i = 0; i < v.Size(); ++i) {
+                assert(sv[i] == v[i]);
+            }
+        }
+    }
+
+    // Нарушение бросает исключение, чтобы тест мог его поймать
+    struct ThrowingIteratorChecks : IteratorChecks {
+        [[noreturn]] static void OnViolation(const char* message) {
+            throw std::logic_error(message);
+        }
     };
 
+    template <typename Action>
+    bool Violates(Action action) {
+        try {
+            action();
+        } catch (const std::logic_error&) {
+            return true;
+        }
+        return false;
+    }
+
+    struct TracedStatsTag {
+        static constexpr const char* kName = "traced";
+    };
+
+    std::vector<ReallocationEvent> traced_events;
+
+    void RecordReallocation(const ReallocationEvent& event) noexcept {
+        traced_events.push_back(event);
+    }
+
 }  // namespace
 
+template <>
+struct is_trivially_relocatable<RelocatableObj> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -380,6 +645,2043 @@ void Test5() {
     }
 }
 
+void Test6() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        int allocations = 0;
+        {
+            TrackingAllocator<Obj> alloc(1, &allocations);
+            Vector<Obj, TrackingAllocator<Obj>> v(SIZE, alloc);
+            assert(allocations == 1);
+            v.PushBack(Obj{ID});
+            assert(v.Capacity() == SIZE * 2);
+            assert(allocations == 1);
+            assert(v.GetAllocator() == alloc);
+
+            const auto v_copy(v);
+            assert(allocations == 2);
+            assert(v_copy.GetAllocator() == alloc);
+            assert(v_copy[SIZE].id == ID);
+        }
+        assert(allocations == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        int first_allocations = 0;
+        int second_allocations = 0;
+        {
+            Vector<Obj, TrackingAllocator<Obj>> first(SIZE, TrackingAllocator<Obj>(1, &first_allocations));
+            Vector<Obj, TrackingAllocator<Obj>> second(TrackingAllocator<Obj>(2, &second_allocations));
+            first[SIZE - 1].id = ID;
+
+            // Аллокаторы не равны и не распространяются: элементы перемещаются поштучно
+            second = std::move(first);
+            assert(second.Size() == SIZE);
+            assert(second[SIZE - 1].id == ID);
+            assert(second.GetAllocator().id == 2);
+            assert(second_allocations == 1);
+            assert(first_allocations == 1);
+            assert(Obj::num_moved == SIZE);
+        }
+        assert(first_allocations == 0);
+        assert(second_allocations == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        int allocations = 0;
+        TrackingAllocator<int> alloc(1, &allocations);
+        Vector<int, TrackingAllocator<int>> first(SIZE, alloc);
+        Vector<int, TrackingAllocator<int>> second(alloc);
+        second = std::move(first);
+        assert(second.Size() == SIZE);
+        assert(first.Size() == 0);
+        assert(allocations == 1);
+    }
+}
+
+void Test7() {
+    const size_t SIZE = 1000;
+    static_assert(is_trivially_relocatable_v<int>);
+    static_assert(!is_trivially_relocatable_v<Obj>);
+    static_assert(is_trivially_relocatable_v<RelocatableObj>);
+    {
+        Vector<int> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        v.Emplace(v.begin() + SIZE / 2, -1);
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE + 1);
+        assert(v[SIZE / 2] == -1);
+        assert(v[SIZE / 2 - 1] == static_cast<int>(SIZE / 2 - 1));
+        assert(v[SIZE] == static_cast<int>(SIZE - 1));
+    }
+    {
+        Vector<RelocatableObj> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        const auto& first = v[0];
+        v.PushBack(first);
+        v.Reserve(SIZE * 4);
+        // При переносе не вызываются ни перемещения, ни деструкторы
+        assert(RelocatableObj::num_moved == 0);
+        assert(RelocatableObj::num_copied == 1);
+        assert(RelocatableObj::num_destroyed == 0);
+        assert(v[SIZE].id == 0);
+        assert(v[SIZE - 1].id == static_cast<int>(SIZE - 1));
+    }
+    assert(RelocatableObj::num_destroyed == static_cast<int>(SIZE + 1));
+}
+
+void Test8() {
+    {
+        // Рост через realloc
+        const size_t SIZE = 1'000'000;
+        Vector<uint64_t, MallocAllocator<uint64_t>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == i);
+        }
+        v.Reserve(SIZE * 3);
+        assert(v.Capacity() == SIZE * 3);
+        assert(v[SIZE - 1] == SIZE - 1);
+    }
+    {
+        // После порога — через mremap, в том числе при переходе через порог в обе стороны
+        const size_t SIZE = 1'000'000;
+        Vector<uint64_t, MmapAllocator<uint64_t>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        v.Reserve(SIZE * 3);
+        assert(v.Capacity() == SIZE * 3 && v[SIZE - 1] == SIZE - 1);
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10 && v[9] == 9);
+    }
+    {
+        Vector<TestObj, MallocAllocator<TestObj>> v(1);
+        assert(v.Size() == v.Capacity());
+        // Ссылка на элемент старого буфера остаётся безопасной при росте на месте
+        v.PushBack(v[0]);
+        v.EmplaceBack(v[1]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+        assert(v[2].IsAlive());
+    }
+    {
+        Vector<RelocatableObj, MallocAllocator<RelocatableObj>> v;
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        v.Emplace(v.begin(), 0);
+        assert(v.Size() == 3);
+        assert(v[0].id == 0 && v[1].id == 1 && v[2].id == 2);
+    }
+}
+
+void Test9() {
+    const size_t INLINE_SIZE = 4;
+    const int ID = 42;
+    using namespace std::literals;
+    {
+        Obj::ResetCounters();
+        int allocations = 0;
+        {
+            SmallVector<Obj, INLINE_SIZE, TrackingAllocator<Obj>> v(TrackingAllocator<Obj>(1, &allocations));
+            assert(v.Capacity() == INLINE_SIZE);
+            for (size_t i = 0; i < INLINE_SIZE; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            assert(allocations == 0);
+            assert(v.Capacity() == INLINE_SIZE);
+
+            v.Insert(v.begin(), Obj{ID});
+            assert(allocations == 1);
+            assert(v.Size() == INLINE_SIZE + 1);
+            assert(v.Capacity() == INLINE_SIZE * 2);
+            assert(v[0].id == ID);
+            assert(v[INLINE_SIZE].id == static_cast<int>(INLINE_SIZE - 1));
+
+            v.Erase(v.begin());
+            assert(v[0].id == 0);
+        }
+        assert(allocations == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, INLINE_SIZE> inline_v;
+        inline_v.EmplaceBack(ID, "Ivan"s);
+        inline_v.Resize(INLINE_SIZE);
+        assert(inline_v.Size() == INLINE_SIZE);
+
+        SmallVector<Obj, INLINE_SIZE> heap_v(INLINE_SIZE * 2);
+        heap_v[0].id = ID + 1;
+
+        // Встроенные элементы переносятся поштучно, буфер в куче передаётся целиком
+        inline_v.Swap(heap_v);
+        assert(inline_v.Size() == INLINE_SIZE * 2);
+        assert(inline_v[0].id == ID + 1);
+        assert(heap_v.Size() == INLINE_SIZE);
+        assert(heap_v[0].id == ID);
+        assert(heap_v.Capacity() == INLINE_SIZE);
+
+        SmallVector<Obj, INLINE_SIZE> moved(std::move(heap_v));
+        assert(moved.Size() == INLINE_SIZE);
+        assert(moved[0].id == ID);
+        assert(heap_v.Size() == 0);
+
+        const auto copy(inline_v);
+        assert(copy.Size() == INLINE_SIZE * 2);
+        assert(copy[0].id == ID + 1);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(INLINE_SIZE * 5));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, INLINE_SIZE> v(INLINE_SIZE);
+        v[INLINE_SIZE - 1].throw_on_copy = true;
+        try {
+            SmallVector<Obj, INLINE_SIZE> v_copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(INLINE_SIZE));
+    }
+    {
+        SmallVector<TestObj, 1> v(1);
+        // Операция PushBack существующего элемента должна быть безопасна при переходе в кучу
+        v.PushBack(v[0]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+    }
+    {
+        // Исключение при обмене встроенных буферов не должно терять элементы ни одной из сторон
+        for (int countdown : {1, 2, 4}) {
+            SmallVector<CopyOnlyObj, INLINE_SIZE> a;
+            a.EmplaceBack(1);
+            a.EmplaceBack(2);
+            SmallVector<CopyOnlyObj, INLINE_SIZE> b;
+            b.EmplaceBack(3);
+            CopyOnlyObj::copy_throw_countdown = countdown;
+            try {
+                a.Swap(b);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            CopyOnlyObj::copy_throw_countdown = 0;
+            assert(a.Size() == 2 && a[0].id == 1 && a[1].id == 2);
+            assert(b.Size() == 1 && b[0].id == 3);
+        }
+    }
+    {
+        SmallVector<int, INLINE_SIZE, MallocAllocator<int>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == 100);
+        assert(v[0] == 0 && v[99] == 99);
+    }
+}
+
+void Test10() {
+    static_assert(DoublingGrowth::NextCapacity(0, 1, sizeof(int)) == 1);
+    assert(DoublingGrowth::NextCapacity(8, 9, sizeof(int)) == 16);
+    assert(DoublingGrowth::NextCapacity(8, 100, sizeof(int)) == 100);
+    assert(OneAndHalfGrowth::NextCapacity(0, 1, sizeof(int)) == 1);
+    assert(OneAndHalfGrowth::NextCapacity(1, 2, sizeof(int)) == 2);
+    assert(OneAndHalfGrowth::NextCapacity(10, 11, sizeof(int)) == 15);
+    assert(GoldenRatioGrowth::NextCapacity(1000, 1001, sizeof(int)) == 1618);
+    // До 128 байт классы идут с шагом 16: 20 байт округляются до 32, 52 — до 64;
+    // дальше по четыре класса на удвоение: 100 — до 112, 129 — до 160
+    static_assert(SizeClassGrowth<>::RoundToSizeClass(1) == 8 && SizeClassGrowth<>::RoundToSizeClass(9) == 16);
+    assert(SizeClassGrowth<>::RoundToSizeClass(20) == 32);
+    assert(SizeClassGrowth<>::RoundToSizeClass(33) == 48);
+    assert(SizeClassGrowth<>::RoundToSizeClass(52) == 64);
+    assert(SizeClassGrowth<>::RoundToSizeClass(128) == 128);
+    assert(SizeClassGrowth<>::RoundToSizeClass(257) == 320);
+    assert(SizeClassGrowth<>::RoundToSizeClass(100) == 112);
+    assert(SizeClassGrowth<>::RoundToSizeClass(129) == 160);
+    assert(SizeClassGrowth<>::NextCapacity(25, 26, sizeof(int)) == 56);
+    {
+        using Growth = FixedStepGrowth<1024>;
+        assert(Growth::NextCapacity(128, 129, sizeof(int)) == 256);
+        assert(Growth::NextCapacity(256, 257, sizeof(int)) == 512);
+        assert(Growth::NextCapacity(512, 513, sizeof(int)) == 768);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj, std::allocator<Obj>, OneAndHalfGrowth> v;
+        size_t reallocations = 0;
+        size_t capacity = v.Capacity();
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+            if (v.Capacity() != capacity) {
+                assert(v.Capacity() == OneAndHalfGrowth::NextCapacity(capacity, v.Size(), sizeof(Obj)));
+                capacity = v.Capacity();
+                ++reallocations;
+            }
+        }
+        assert(v[99].id == 99);
+        // 1, 2, 3, 4, 6, 9, 13, 19, 28, 42, 63, 94, 141
+        assert(reallocations == 13);
+        assert(v.Capacity() == 141);
+        v.Resize(v.Capacity());
+        v.Insert(v.begin(), Obj{-1});
+        assert(v.Capacity() == 141 + 141 / 2);
+        assert(v[0].id == -1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<int, 2, std::allocator<int>, SizeClassGrowth<>> v;
+        for (int i = 0; i < 3; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 4);
+    }
+}
+
+void Test11() {
+    const size_t SIZE = 10;
+    const int ID = 42;
+    {
+        Vector<int> v;
+        const int source[] = {1, 2, 3, 4, 5};
+        v.Append(std::begin(source), std::end(source));
+        assert(v.Size() == 5);
+        assert(v.Capacity() == 5);
+
+        // Вставка внутрь без перевыделения и с ним
+        v.Reserve(20);
+        v.Insert(v.begin() + 1, std::begin(source), std::begin(source) + 2);
+        v.Insert(v.begin(), 3, -1);
+        const int expected[] = {-1, -1, -1, 1, 1, 2, 2, 3, 4, 5};
+        assert(v.Size() == std::size(expected));
+        assert(std::equal(v.begin(), v.end(), std::begin(expected)));
+
+        auto it = v.Insert(v.end() - 1, 15, v[0]);
+        assert(it == v.begin() + 9);
+        assert(v.Size() == 25);
+        assert(v.Capacity() == 40);
+        assert(v[9] == -1 && v[23] == -1 && v[24] == 5);
+
+        v.AppendDefault(SIZE);
+        assert(v.Size() == 25 + SIZE);
+        assert(v[25] == 0 && v[34] == 0);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> source;
+        for (size_t i = 0; i < SIZE; ++i) {
+            source.EmplaceBack(static_cast<int>(i));
+        }
+        Vector<Obj> v;
+        v.Reserve(SIZE * 2);
+        v.EmplaceBack(-1);
+        v.EmplaceBack(-2);
+        const int old_copied = Obj::num_copied;
+        const int old_moved = Obj::num_moved;
+        v.Insert(v.begin() + 1, source.begin(), source.end());
+        assert(v.Size() == SIZE + 2);
+        assert(v[0].id == -1 && v[1].id == 0 && v[SIZE].id == static_cast<int>(SIZE - 1) && v[SIZE + 1].id == -2);
+        // Хвост сдвигается один раз: одно перемещение, остальное копируется на место
+        assert(Obj::num_copied - old_copied == static_cast<int>(SIZE - 1));
+        assert(Obj::num_moved - old_moved == 1);
+
+        // Исключение при копировании диапазона на перевыделении не меняет вектор
+        source[SIZE / 2].throw_on_copy = true;
+        try {
+            v.Insert(v.begin(), source.begin(), source.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE + 2);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[0].id == -1 && v[SIZE + 1].id == -2);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE * 2 + 2));
+
+        v.AppendDefault(SIZE);
+        assert(v.Size() == SIZE * 2 + 2);
+        assert(v[SIZE * 2 + 1].id == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<int> v(2);
+        v.Reserve(100);
+        const int source[] = {1, 2, 3};
+        v.Insert(v.begin() + 1, std::begin(source), std::end(source));
+        const int expected[] = {0, 1, 2, 3, 0};
+        assert(std::equal(v.begin(), v.end(), std::begin(expected)));
+    }
+    {
+        std::istringstream input("1 2 3 4");
+        Vector<Obj> v;
+        v.EmplaceBack(ID);
+        v.Insert(v.begin(), std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(v.Size() == 5);
+        assert(v[0].id == 1 && v[3].id == 4 && v[4].id == ID);
+    }
+}
+
+void Test12() {
+    const size_t SIZE = 100;
+    {
+        Vector<int> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        auto it = v.Erase(v.begin() + 10, v.begin() + 20);
+        assert(*it == 20);
+        assert(v.Size() == SIZE - 10);
+        assert(v.Erase(v.begin(), v.begin()) == v.begin());
+
+        const size_t removed = EraseIf(v, [](int x) { return x % 2 != 0; });
+        assert(removed == (SIZE - 10) / 2);
+        assert(v.Size() == (SIZE - 10) / 2);
+        for (size_t i = 1; i < v.Size(); ++i) {
+            assert(v[i] % 2 == 0 && v[i - 1] < v[i]);
+        }
+        assert(v.Capacity() == 128);
+        assert(EraseIf(v, [](int) { return false; }) == 0);
+
+        // Предикат с состоянием вызывается по одному разу для каждого элемента
+        const size_t size = v.Size();
+        size_t calls = 0;
+        assert(EraseIf(v, [&calls](int) { return calls++ % 3 == 1; }) == size / 3);
+        assert(calls == size && v.Size() == size - size / 3 && v[0] == 0 && v[1] == 4);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Erase(v.end() - 10, v.end());
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE - 10));
+
+        const int old_destroyed = Obj::num_destroyed;
+        const size_t removed = EraseIf(v, [](const Obj& obj) { return obj.id < 50; });
+        assert(removed == 50);
+        assert(v.Size() == SIZE - 60);
+        assert(v[0].id == 50 && v[v.Size() - 1].id == static_cast<int>(SIZE - 11));
+        assert(Obj::num_destroyed - old_destroyed == 50);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE - 60));
+
+        size_t calls = 0;
+        size_t seen = 0;
+        const size_t size = v.Size();
+        EraseIf(v, [&calls, &seen](const Obj& obj) {
+            ++calls;
+            seen += obj.id == 50 ? 1 : 0;
+            return obj.id % 2 == 0;
+        });
+        assert(calls == size && seen == 1 && v.Size() == size / 2 && v[0].id == 51);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<RelocatableObj> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        const int old_destroyed = RelocatableObj::num_destroyed;
+        v.Erase(v.begin() + 2, v.begin() + 5);
+        assert(RelocatableObj::num_destroyed - old_destroyed == 3);
+        assert(v.Size() == 7 && v[2].id == 5 && v[6].id == 9);
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 1000;
+    {
+        Vector<char> v(SIZE, default_init);
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE);
+        std::fill(v.begin(), v.end(), 'x');
+
+        auto chunk = v.AppendUninitialized(SIZE / 2);
+        assert(chunk.Size() == SIZE / 2);
+        assert(chunk.Data() == v.begin() + SIZE);
+        assert(v.Size() == SIZE + SIZE / 2);
+        assert(v.Capacity() == SIZE * 2);
+        std::fill(chunk.begin(), chunk.end(), 'y');
+        assert(v[SIZE - 1] == 'x' && v[SIZE] == 'y' && v[SIZE + SIZE / 2 - 1] == 'y');
+
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        v.ResizeDefaultInit(SIZE * 3);
+        assert(v.Size() == SIZE * 3);
+        assert(v.Capacity() == SIZE * 3);
+        assert(v[0] == 'x');
+    }
+    {
+        Vector<float, MallocAllocator<float>> v;
+        auto chunk = v.AppendUninitialized(SIZE);
+        for (size_t i = 0; i < chunk.Size(); ++i) {
+            chunk[i] = static_cast<float>(i);
+        }
+        assert(v[SIZE - 1] == static_cast<float>(SIZE - 1));
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Resize(SIZE / 2);
+        assert(v.Capacity() == SIZE);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+
+        v.Clear();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        v.Resize(SIZE);
+        v.ClearAndRelease();
+        assert(v.Capacity() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(SIZE);
+        v[SIZE / 2 - 1] = 42;
+        v.Resize(SIZE / 2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 2);
+        assert(v[SIZE / 2 - 1] == 42);
+        v.Resize(0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, 4> v(SIZE);
+        v[1].id = 42;
+        v.Resize(2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 4);
+        assert(v.Size() == 2);
+        assert(v[1].id == 42);
+        assert(Obj::GetAliveObjectCount() == 2);
+    }
+    {
+        Vector<int, std::allocator<int>, AutoShrinkGrowth<>> v;
+        for (size_t i = 0; i < SIZE * 10; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v.Capacity() == 1024);
+        while (v.Size() > 256) {
+            v.PopBack();
+        }
+        assert(v.Capacity() == 1024);
+        v.PopBack();
+        assert(v.Size() == 255);
+        assert(v.Capacity() == 510);
+
+        // Вблизи границы ёмкость не меняется
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+            v.PopBack();
+        }
+        assert(v.Capacity() == 510);
+        assert(v[254] == 254);
+
+        v.Erase(v.begin() + 10, v.end());
+        assert(v.Size() == 10);
+        assert(v.Capacity() == 20);
+        v.Resize(1);
+        assert(v.Capacity() == 16);
+        // Малые буферы не сжимаются
+        v.PopBack();
+        assert(v.Capacity() == 16);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 10;
+    const int ID = 42;
+    using namespace std::literals;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(SIZE * 2);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        // Перемещение небросающее и аргументы не указывают в вектор: без временного объекта
+        const int old_moved = Obj::num_moved;
+        v.Emplace(v.begin() + 1, Obj{ID});
+        assert(Obj::num_moved - old_moved == 2);
+        assert(v[1].id == ID && v[2].id == 1 && v[SIZE].id == static_cast<int>(SIZE - 1));
+
+        auto it = v.Emplace(v.begin(), v[SIZE]);
+        assert(it == v.begin());
+        assert(v[0].id == static_cast<int>(SIZE - 1));
+        assert(v[SIZE + 1].id == static_cast<int>(SIZE - 1));
+
+        v.Emplace(v.begin() + 2, ID, "Ivan"s);
+        assert(v[2].id == ID && v[2].name == "Ivan"s);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + 3));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Исключение при создании элемента оставляет вектор неизменным
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(SIZE * 2);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        Obj source(ID);
+        source.throw_on_copy = true;
+        try {
+            v.Insert(v.begin() + 1, source);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i].id == static_cast<int>(i));
+        }
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + 1));
+    }
+    {
+        Vector<RelocatableObj> v;
+        v.Reserve(SIZE * 2);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        const int old_moved = RelocatableObj::num_moved;
+        v.Emplace(v.begin() + 1, ID);
+        // Аргумент указывает на сдвигаемый элемент
+        v.Insert(v.begin(), v[SIZE]);
+        assert(RelocatableObj::num_moved == old_moved);
+        assert(v.Size() == SIZE + 2);
+        assert(v[0].id == static_cast<int>(SIZE - 1));
+        assert(v[2].id == ID);
+        assert(v[SIZE + 1].id == static_cast<int>(SIZE - 1));
+    }
+    {
+        Vector<std::string> v;
+        v.Reserve(SIZE);
+        v.PushBack("a"s);
+        v.PushBack("b"s);
+        v.Emplace(v.begin(), v[1]);
+        v.Emplace(v.begin() + 1, 3, 'c');
+        assert(v.Size() == 4);
+        assert(v[0] == "b"s && v[1] == "ccc"s && v[2] == "a"s && v[3] == "b"s);
+    }
+}
+
+void Test16() {
+    const size_t SIZE = 100;
+    using Stats = VectorStats<OrdersStatsTag>;
+    static_assert(sizeof(Vector<int>) == sizeof(Vector<int, std::allocator<int>, DoublingGrowth, Stats>));
+    Stats::Counters().Reset();
+    {
+        Obj::ResetCounters();
+        Vector<Obj, std::allocator<Obj>, DoublingGrowth, Stats> v(SIZE);
+        v.PushBack(Obj{1});
+        v.Reserve(SIZE * 4);
+        const auto copy(v);
+
+        const auto snapshot = Stats::Counters().Load();
+        assert(snapshot.allocations == 2);
+        assert(snapshot.reallocations == 2);
+        assert(snapshot.in_place_reallocations == 0);
+        assert(snapshot.elements_moved == SIZE + SIZE + 1);
+        assert(snapshot.elements_copied == 0);
+        assert(snapshot.bytes_allocated == (SIZE + SIZE * 2 + SIZE * 4 + SIZE + 1) * sizeof(Obj));
+        assert(snapshot.peak_capacity_bytes == SIZE * 4 * sizeof(Obj));
+        assert(snapshot.slack_bytes == ((SIZE - 1) + (SIZE * 4 - SIZE - 1)) * sizeof(Obj));
+    }
+    {
+        Vector<int, MallocAllocator<int>, DoublingGrowth, Stats> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        const auto snapshot = Stats::Counters().Load();
+        // 1, 2, 4, ..., 128: восемь ростов на месте, элементы переносятся побайтово
+        assert(snapshot.in_place_reallocations == 8);
+        assert(snapshot.elements_relocated_bitwise == 127);
+    }
+    {
+        std::ostringstream out;
+        VectorStatsRegistry::Instance().Dump(out);
+        assert(out.str().find("vector_reallocations{name=\"orders\"} 10\n") != std::string::npos);
+    }
+}
+
+void Test17() {
+    const size_t SIZE = 100;
+    Arena arena(size_t{1} << 12);
+    {
+        ArenaScope scope(arena);
+        Obj::ResetCounters();
+        {
+            Vector<Obj, ArenaAllocator<Obj>> v{ArenaAllocator<Obj>(arena)};
+            for (size_t i = 0; i < SIZE / 10; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            // Буфер выделен в арене последним и растёт без перемещения элементов
+            assert(Obj::num_moved == 0);
+            assert(v.Capacity() == 16);
+            assert(arena.ChunkCount() == 1);
+
+            // После чужого выделения буфер уже не последний: рост переносит элементы
+            Vector<int, ArenaAllocator<int>> other(SIZE, ArenaAllocator<int>(arena));
+            const size_t target_size = v.Capacity() + 1;
+            for (size_t i = v.Size(); i < target_size; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            assert(Obj::num_moved == 16);
+            assert(v[16].id == 16);
+            assert(other[SIZE - 1] == 0);
+
+            Vector<char, ArenaAllocator<char>> big(size_t{1} << 13, ArenaAllocator<char>(arena));
+            assert(arena.ChunkCount() == 2);
+            const auto copy(v);
+            assert(copy.GetAllocator() == v.GetAllocator());
+            assert(copy[16].id == 16);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    // Отметка снята до первого выделения: арена сброшена до одного блока
+    assert(arena.ChunkCount() == 1);
+    {
+        ArenaScope scope(arena);
+        Vector<uint64_t, ArenaAllocator<uint64_t>> v{ArenaAllocator<uint64_t>(arena)};
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        assert(v[SIZE - 1] == SIZE - 1);
+        assert(arena.ChunkCount() == 1);
+    }
+}
+
+void Test18() {
+    const size_t SIZE = 100;
+    {
+        // Освобождённый буфер возвращается в кеш потока и переиспользуется
+        const int* first_buffer = nullptr;
+        {
+            Vector<int, PoolAllocator<int>> v(SIZE);
+            first_buffer = &v[0];
+        }
+        const size_t cached = SizeClassPool::ThreadCachedBytes();
+        assert(cached >= SIZE * sizeof(int));
+        Vector<int, PoolAllocator<int>> v(SIZE);
+        assert(&v[0] == first_buffer);
+        assert(SizeClassPool::ThreadCachedBytes() < cached);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj, PoolAllocator<Obj>> v;
+        for (size_t i = 0; i < SIZE * 10; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(v[SIZE * 10 - 1].id == static_cast<int>(SIZE * 10 - 1));
+        // Буферы больше старшего класса выделяются напрямую
+        Vector<char, PoolAllocator<char>> huge(size_t{4} << 20);
+        huge[0] = 'x';
+        assert(huge[0] == 'x');
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Буфер, выделенный в другом потоке, возвращается владельцу через общий стек
+        Vector<Vector<int, PoolAllocator<int>>> produced;
+        std::thread producer([&] {
+            for (size_t i = 0; i < SIZE; ++i) {
+                produced.EmplaceBack(SIZE);
+            }
+        });
+        producer.join();
+        assert(produced.Size() == SIZE);
+        produced.Clear();
+
+        std::thread consumer([] {
+            SizeClassPool::SetThreadCacheLimit(0);
+            Vector<int, PoolAllocator<int>> v(SIZE);
+            v.PushBack(1);
+            assert(SizeClassPool::ThreadCachedBytes() == 0);
+            v.ClearAndRelease();
+            assert(SizeClassPool::ThreadCachedBytes() == 0);
+        });
+        consumer.join();
+    }
+}
+
+void Test19() {
+    const size_t SIZE = 1000;
+    {
+        // Allocator подменяется на выровненный аллокатор нужного типа
+        using AlignedFloats = Vector<float, Aligned<64>>;
+        static_assert(std::is_same_v<AlignedFloats::allocator_type, AlignedAllocator<float, 64, (size_t{2} << 20)>>);
+        AlignedFloats v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(reinterpret_cast<uintptr_t>(&v[0]) % 64 == 0);
+        }
+        assert(v[SIZE - 1] == static_cast<float>(SIZE - 1));
+        AlignedFloats copy(v);
+        assert(reinterpret_cast<uintptr_t>(&copy[0]) % 64 == 0);
+        assert(copy[SIZE / 2] == static_cast<float>(SIZE / 2));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj, Aligned<4096>> v(SIZE);
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % 4096 == 0);
+        v.Insert(v.begin() + 1, Obj(1));
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % 4096 == 0);
+        assert(v.Size() == SIZE + 1 && v[1].id == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Буфер от порога огромных страниц выравнивается на их границу
+        const size_t huge_page = Aligned<64>::kHugePageSize;
+        Vector<uint64_t, Aligned<64, (size_t{1} << 20)>> v;
+        v.Resize(huge_page / sizeof(uint64_t) / 4);
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % 64 == 0);
+        v.Resize(huge_page / sizeof(uint64_t) + 1);
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % huge_page == 0);
+        v[v.Size() - 1] = 42;
+        v.ShrinkToFit();
+        assert(v[v.Size() - 1] == 42);
+    }
+}
+
+void Test20() {
+    struct Record {
+        int id;
+        double value;
+    };
+    const size_t SIZE = 100000;
+    const std::string path = (std::filesystem::temp_directory_path() / "advanced_vector_test20.bin").string();
+    std::remove(path.c_str());
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 0 && !v.IsReadOnly());
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack({static_cast<int>(i), i * 0.5});
+        }
+        assert(v.Size() == SIZE && v.Capacity() >= SIZE);
+        // Аргумент, ссылающийся на запись, переживает рост файла
+        v.PushBack(v[0]);
+        assert(v[SIZE].id == 0);
+        v.PopBack();
+        v.EmplaceBack(-2, 1.5);
+        assert(v[SIZE].id == -2 && v[SIZE].value == 1.5);
+        v.PopBack();
+        v.Sync();
+    }
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == SIZE);
+        assert(v[SIZE - 1].id == static_cast<int>(SIZE - 1) && v[SIZE - 1].value == (SIZE - 1) * 0.5);
+        v.Insert(v.begin() + 1, {-1, 0.0});
+        assert(v[1].id == -1 && v[2].id == 1);
+        v.Erase(v.begin() + 1);
+        v.Erase(v.begin(), v.begin() + 10);
+        assert(v.Size() == SIZE - 10 && v[0].id == 10);
+        const size_t capacity = v.Capacity();
+        v.ShrinkToFit();
+        assert(v.Capacity() >= v.Size() && v.Capacity() < capacity);
+        v.Resize(SIZE);
+        assert(v[SIZE - 1].id == 0 && v[SIZE - 11].id == static_cast<int>(SIZE - 1));
+    }
+    {
+        // Несколько читателей отображают один файл
+        const MappedVector<Record> reader1(path, MapMode::kReadOnly);
+        MappedVector<Record> reader2(path, MapMode::kReadOnly);
+        assert(reader1.IsReadOnly());
+        assert(reader1.Size() == SIZE && reader2.Size() == SIZE);
+        int sum = 0;
+        for (const Record& record : reader1) {
+            sum += record.id == std::as_const(reader2)[&record - reader1.begin()].id ? 1 : 0;
+        }
+        assert(sum == static_cast<int>(SIZE));
+        // Изменение отображения только для чтения отклоняется до записи в страницы
+        assert(Violates([&] { reader2.PushBack({0, 0.0}); }));
+        assert(Violates([&] { reader2[0].id = 1; }));
+        assert(Violates([&] { reader2.Erase(reader2.cbegin()); }));
+        assert(Violates([&] { reader2.Clear(); }));
+        assert(Violates([&] { reader2.begin(); }));
+        assert(reader2.Size() == SIZE && reader2.cbegin()->id == 10);
+        MappedVector<Record> moved(std::move(reader2));
+        assert(moved.Size() == SIZE && reader2.Size() == 0);
+    }
+    {
+        bool thrown = false;
+        try {
+            MappedVector<int> wrong_type(path, MapMode::kReadOnly);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        thrown = false;
+        try {
+            MappedVector<int> missing(path + ".missing", MapMode::kReadOnly);
+        } catch (const std::system_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    std::remove(path.c_str());
+}
+
+void Test21() {
+    const size_t SIZE = 10000;
+    {
+        // Образ буфера через файловый дескриптор
+        Vector<uint64_t> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i * i);
+        }
+        std::FILE* file = std::tmpfile();
+        assert(file != nullptr);
+        const int fd = fileno(file);
+        WriteTo(fd, v);
+        WriteTo(fd, Vector<uint64_t>());
+        lseek(fd, 0, SEEK_SET);
+        Vector<uint64_t, MallocAllocator<uint64_t>> restored;
+        ReadFrom(fd, restored);
+        assert(restored.Size() == SIZE && restored.Capacity() == SIZE);
+        assert(std::equal(v.begin(), v.end(), restored.begin()));
+        ReadFrom(fd, restored);
+        assert(restored.Size() == 0);
+        std::fclose(file);
+    }
+    {
+        // Поэлементное кодирование и SmallVector
+        SmallVector<std::string, 2> v;
+        for (size_t i = 0; i < SIZE / 100; ++i) {
+            v.PushBack(std::string(i, 'a' + i % 26));
+        }
+        std::stringstream stream;
+        WriteTo(stream, v);
+        Vector<std::string> restored;
+        restored.PushBack("old");
+        ReadFrom(stream, restored);
+        assert(restored.Size() == v.Size());
+        assert(std::equal(v.begin(), v.end(), restored.begin()));
+    }
+    {
+        // Повреждённые данные и элементы другого размера отвергаются, вектор остаётся пустым
+        Vector<int> v(SIZE);
+        v[SIZE / 2] = 1;
+        std::stringstream stream;
+        WriteTo(stream, v);
+        std::string bytes = stream.str();
+        bytes[sizeof(SerializedVectorHeader) + SIZE] ^= 1;
+
+        // Цель непуста, чтобы проверить, что её очищает и ошибка в заголовке
+        auto fails = [](const std::string& data, auto& target) {
+            std::istringstream in(data);
+            target.Resize(3);
+            try {
+                ReadFrom(in, target);
+            } catch (const std::runtime_error&) {
+                return target.Size() == 0;
+            }
+            return false;
+        };
+        Vector<int> restored;
+        assert(fails(bytes, restored));
+        Vector<double> wrong_size;
+        assert(fails(stream.str(), wrong_size));
+        Vector<std::string> wrong_encoding;
+        assert(fails(stream.str(), wrong_encoding));
+        assert(fails(stream.str().substr(0, stream.str().size() - 1), restored));
+        assert(fails(stream.str().substr(0, 4), restored));
+        std::istringstream in(stream.str());
+        ReadFrom(in, restored);
+        assert(restored.Size() == SIZE && restored[SIZE / 2] == 1);
+    }
+}
+
+void Test22() {
+    const size_t SIZE = 100;
+    {
+        // Буфер от malloc передаётся вектору и обратно без копирования
+        char* raw = static_cast<char*>(std::malloc(SIZE));
+        assert(raw != nullptr);
+        std::memset(raw, 'x', SIZE / 2);
+        Vector<char, MallocAllocator<char>> v;
+        v.Adopt(raw, SIZE / 2, SIZE);
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE && &v[0] == raw);
+        v.PushBack('y');
+        assert(&v[0] == raw && v[SIZE / 2] == 'y');
+        v.Resize(SIZE * 100);
+
+        auto buffer = v.Release();
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        assert(buffer.Size() == SIZE * 100 && buffer.Capacity() >= buffer.Size());
+        assert(buffer.Data()[0] == 'x' && buffer.Data()[SIZE / 2] == 'y');
+        std::free(buffer.Detach());
+        assert(buffer.Data() == nullptr);
+    }
+    {
+        // Большой буфер от malloc растёт и освобождается тем же malloc, а не mremap/munmap
+        const size_t LARGE = size_t{2} << 20;
+        char* raw = static_cast<char*>(std::malloc(LARGE));
+        assert(raw != nullptr);
+        raw[LARGE - 1] = 'z';
+        Vector<char, MallocAllocator<char>> v;
+        v.Adopt(raw, LARGE, LARGE);
+        v.PushBack('y');
+        assert(v.Size() == LARGE + 1 && v[LARGE - 1] == 'z' && v[LARGE] == 'y');
+        std::free(v.Release().Detach());
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        const Obj* data = &v[0];
+        auto buffer = v.Release();
+        assert(Obj::GetAliveObjectCount() == SIZE);
+        auto moved = std::move(buffer);
+
+        Vector<Obj> other(1);
+        other.Adopt(std::move(moved));
+        assert(moved.Data() == nullptr);
+        assert(other.Size() == SIZE && &other[0] == data);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+        // Дескриптор, не переданный дальше, сам разрушает элементы
+        VectorBuffer<Obj, std::allocator<Obj>> dropped = other.Release();
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test23() {
+    const size_t SIZE = size_t{1} << 22;
+    const parallel_t four_threads{4};
+    {
+        Vector<int> v(SIZE, four_threads);
+        assert(v.Size() == SIZE);
+        assert(std::all_of(v.begin(), v.end(), [](int x) { return x == 0; }));
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = static_cast<int>(i);
+        }
+        const Vector<int> copy(v, parallel);
+        assert(std::equal(v.begin(), v.end(), copy.begin()));
+        v.Resize(SIZE / 2);
+        v.Resize(SIZE * 2, four_threads);
+        assert(v[SIZE / 2 - 1] == static_cast<int>(SIZE / 2 - 1) && v[SIZE / 2] == 0 && v[SIZE * 2 - 1] == 0);
+    }
+    {
+        // Короткий диапазон создаётся без потоков
+        Vector<int> v(10, parallel);
+        assert(v.Size() == 10 && v[9] == 0);
+    }
+    {
+        Vector<ConcurrentObj> v(SIZE / 4, four_threads);
+        assert(ConcurrentObj::num_alive == static_cast<int>(SIZE / 4));
+        Vector<ConcurrentObj> copy(v, four_threads);
+        assert(ConcurrentObj::num_alive == static_cast<int>(SIZE / 2));
+
+        // Исключение в одной из частей: созданные части разрушаются
+        ConcurrentObj::construction_throw_countdown = static_cast<int>(SIZE / 8);
+        try {
+            Vector<ConcurrentObj> failed(SIZE / 4, four_threads);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(ConcurrentObj::num_alive == static_cast<int>(SIZE / 2));
+
+        ConcurrentObj::construction_throw_countdown = static_cast<int>(SIZE / 8);
+        try {
+            v.Resize(SIZE, four_threads);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE / 4 && ConcurrentObj::num_alive == static_cast<int>(SIZE / 2));
+        ConcurrentObj::construction_throw_countdown = 0;
+    }
+    assert(ConcurrentObj::num_alive == 0);
+}
+
+void Test24() {
+    const size_t THREADS = 8;
+    const size_t PER_THREAD = 20000;
+    {
+        ConcurrentVector<size_t> v;
+        const size_t& first = v.EmplaceBack(size_t{0});
+        std::atomic<bool> done{false};
+        std::thread reader([&] {
+            // Читатель видит только созданные элементы
+            while (!done.load()) {
+                const size_t size = v.Size();
+                for (size_t i = 0; i < size; i += 97) {
+                    if (const size_t* value = v.TryGet(i)) {
+                        assert(*value < THREADS * PER_THREAD + 1);
+                    }
+                }
+            }
+        });
+        Vector<std::thread> writers;
+        for (size_t t = 0; t < THREADS; ++t) {
+            writers.EmplaceBack([&v, t, PER_THREAD] {
+                for (size_t i = 0; i < PER_THREAD; ++i) {
+                    v.PushBack(t * PER_THREAD + i + 1);
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        reader.join();
+
+        assert(v.Size() == THREADS * PER_THREAD + 1);
+        assert(&first == &v[0] && first == 0);
+        Vector<bool> seen(v.Size());
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v.TryGet(i) == &v[i]);
+            assert(!seen[v[i]]);
+            seen[v[i]] = true;
+        }
+        assert(v.TryGet(v.Size()) == nullptr);
+    }
+    {
+        ConcurrentVector<ConcurrentObj> v;
+        v.Reserve(100);
+        v.EmplaceBack();
+        ConcurrentObj::construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        v.PushBack(v[0]);
+        assert(v.Size() == 3 && v.TryGet(1) == nullptr && v.TryGet(2) != nullptr);
+        assert(ConcurrentObj::num_alive == 2);
+    }
+    assert(ConcurrentObj::num_alive == 0);
+    {
+        // Писатели, одновременно перешедшие границу, выделяют сегмент один раз
+        using Counted = CountingAllocator<size_t>;
+        Counted::allocations = 0;
+        ConcurrentVector<size_t, Counted> v;
+        std::atomic<bool> start{false};
+        Vector<std::thread> writers;
+        for (size_t t = 0; t < THREADS; ++t) {
+            writers.EmplaceBack([&v, &start, PER_THREAD] {
+                while (!start.load()) {
+                }
+                for (size_t i = 0; i < PER_THREAD; ++i) {
+                    v.PushBack(i);
+                }
+            });
+        }
+        start = true;
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        int segments = 0;
+        size_t end = 0;
+        for (; end < v.Size(); end = end * 2 + decltype(v)::kFirstSegmentSize) {
+            ++segments;
+        }
+        assert(v.Size() == THREADS * PER_THREAD && Counted::allocations == segments);
+        v.Reserve(end + 1);
+        assert(Counted::allocations == segments + 1);
+    }
+}
+
+void Test25() {
+    const size_t SIZE = 300;
+    const SimdIsa active = ActiveSimdIsa();
+    Vector<SimdIsa> isas;
+    for (SimdIsa isa : {SimdIsa::kScalar, SimdIsa::kNeon, SimdIsa::kAvx2, SimdIsa::kAvx512}) {
+        if (isa == SimdIsa::kScalar || isa == active || (isa == SimdIsa::kAvx2 && active == SimdIsa::kAvx512)) {
+            isas.PushBack(isa);
+        }
+    }
+    {
+        // Каждое ядро совпадает со скалярным на всех длинах и смещениях
+        Vector<int32_t> ints(SIZE);
+        Vector<float> floats(SIZE);
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < SIZE; ++i) {
+            seed = seed * 1103515245 + 12345;
+            ints[i] = static_cast<int32_t>(seed >> 8) - (1 << 23);
+            floats[i] = static_cast<float>(static_cast<int32_t>(seed >> 26) - 32);
+        }
+        ints[SIZE - 1] = INT32_MIN;
+        for (SimdIsa isa : isas) {
+            for (size_t offset = 0; offset < 3; ++offset) {
+                for (size_t n = 1; n + offset <= SIZE; n += n < 40 ? 1 : 37) {
+                    const int32_t* a = ints.begin() + offset;
+                    const float* f = floats.begin() + offset;
+                    const int32_t needle = a[n / 2];
+                    assert(detail::simd::Find<0>(isa, a, n, needle) == detail::simd::FindScalar(a, n, needle));
+                    assert(detail::simd::Find<0>(isa, a, n, 7) == detail::simd::FindScalar(a, n, 7));
+                    assert(detail::simd::Count<0>(isa, f, n, f[n - 1]) == detail::simd::CountScalar(f, n, f[n - 1]));
+                    assert((detail::simd::Extremum<0, true>(isa, a, n) == detail::simd::MinScalar(a, n)));
+                    assert((detail::simd::Extremum<0, false>(isa, f, n) == detail::simd::MaxScalar(f, n)));
+                    assert(detail::simd::Sum<0>(isa, a, n) == detail::simd::SumScalar(a, n));
+                    assert(detail::simd::Dot<0>(isa, a, a, n) == detail::simd::DotScalar(a, a, n));
+                    // Целочисленные float складываются точно в любом порядке
+                    assert(detail::simd::Sum<0>(isa, f, n) == detail::simd::SumScalar(f, n));
+                    assert(detail::simd::Dot<0>(isa, f, f, n) == detail::simd::DotScalar(f, f, n));
+                }
+            }
+        }
+    }
+    {
+        Vector<float, Aligned<64>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<float>(i % 50));
+        }
+        static_assert(detail::simd::kBufferAlignment<decltype(v), RawMemory<float, AlignedAllocator<float, 64, (size_t{2} << 20)>>> == 64);
+        assert(Find(v, 49.0f) == v.begin() + 49 && Find(v, 50.0f) == v.end());
+        assert(Count(v, 0.0f) == SIZE / 50);
+        assert(*MinElement(v) == 0.0f && MaxElement(v) == v.begin() + 49);
+        assert(Sum(v) == static_cast<float>(SIZE / 50 * (49 * 50 / 2)));
+        assert(Dot(v, v) == detail::simd::DotScalar(v.begin(), v.begin(), v.Size()));
+    }
+    {
+        SmallVector<int, 8> small;
+        Vector<double> doubles;
+        assert(MinElement(small) == small.end() && Sum(small) == 0);
+        for (int i = 0; i < 20; ++i) {
+            small.PushBack(i % 7 - 3);
+            doubles.PushBack(i * 0.5);
+        }
+        assert(MinElement(small) == small.begin() && *MaxElement(small) == 3);
+        assert(Sum(small) == detail::simd::SumScalar(small.begin(), small.Size()));
+        assert(Find(doubles, 2.5) == doubles.begin() + 5 && Sum(doubles) == 95.0);
+    }
+}
+
+void Test26() {
+    const size_t SIZE = 100;
+    {
+        SoaVector<int, std::string, double> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i), std::to_string(i), i * 0.5);
+        }
+        assert(v.Size() == SIZE && v.Capacity() >= SIZE);
+        // Столбцы — непрерывные массивы одной длины
+        Span<int> ids = v.Column<0>();
+        Span<double> prices = v.Column<2>();
+        assert(ids.Size() == SIZE && prices.Size() == SIZE);
+        int id_sum = 0;
+        for (int id : ids) {
+            id_sum += id;
+        }
+        assert(id_sum == static_cast<int>(SIZE * (SIZE - 1) / 2));
+        assert(prices[10] == 5.0);
+
+        auto [id, name, price] = v[42];
+        assert(id == 42 && name == "42" && price == 21.0);
+        name = "forty-two";
+        assert(std::get<1>(v[42]) == "forty-two");
+
+        // Строка, ссылающаяся на сам вектор, копируется до перевыделения
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE);
+        v.PushBack(v[0]);
+        assert(v.Size() == SIZE + 1 && std::get<1>(v[SIZE]) == "0");
+        v.PushBack(std::make_tuple(7, std::string("seven"), 3.5));
+        assert(std::get<0>(v[SIZE + 1]) == 7);
+
+        auto it = v.Erase(v.begin() + 1, v.begin() + 11);
+        assert(it == v.begin() + 1 && std::get<0>(*it) == 11 && v.Size() == SIZE - 8);
+        it = v.Erase(v.begin());
+        assert(std::get<1>(*it) == "11");
+        v.PopBack();
+        assert(std::get<0>(v[v.Size() - 1]) == 0);
+
+        const auto& cv = v;
+        size_t rows = 0;
+        for (auto [row_id, row_name, row_price] : cv) {
+            assert(row_price == row_id * 0.5 && !row_name.empty());
+            ++rows;
+        }
+        assert(rows == cv.Size() && cv.Column<1>().Size() == cv.Size());
+
+        SoaVector<int, std::string, double> copy(v);
+        v.Clear();
+        assert(v.Size() == 0 && copy.Size() == rows && std::get<1>(copy[0]) == "11");
+        v = std::move(copy);
+        assert(v.Size() == rows && copy.Size() == 0);
+    }
+    {
+        // Исключение в поле строки не оставляет созданными остальные поля
+        Obj::ResetCounters();
+        SoaVector<std::string, Obj> v;
+        Obj bad;
+        bad.throw_on_copy = true;
+        for (size_t capacity_left : {0, 1}) {
+            v.Reserve(v.Size() + capacity_left);
+            const size_t capacity = v.Capacity();
+            const int alive = Obj::GetAliveObjectCount();
+            try {
+                v.EmplaceBack(std::string(100, 'x'), bad);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == capacity - capacity_left && v.Capacity() == capacity);
+            assert(Obj::GetAliveObjectCount() == alive);
+            v.EmplaceBack("ok", 1);
+        }
+        assert(v.Size() == 2 && std::get<1>(v[1]).id == 1);
+    }
+    {
+        // Столбец строк не перемещается, пока копирование другого столбца может бросить
+        SoaVector<std::string, CopyOnlyObj> v;
+        v.EmplaceBack(std::string(100, 'a'), 1);
+        v.EmplaceBack(std::string(100, 'b'), 2);
+        assert(v.Capacity() == 2);
+        CopyOnlyObj::copy_throw_countdown = 2;
+        try {
+            v.EmplaceBack("c", 3);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 2 && v.Capacity() == 2);
+        assert(std::get<0>(v[0]) == std::string(100, 'a') && std::get<0>(v[1]) == std::string(100, 'b'));
+        assert(std::get<1>(v[1]).id == 2);
+        CopyOnlyObj::copy_throw_countdown = 0;
+    }
+}
+
+void Test27() {
+    const size_t SIZE = 1000;
+    {
+        Vector<int> source;
+        for (size_t i = 0; i < SIZE; ++i) {
+            source.PushBack(static_cast<int>(i));
+        }
+        const int* buffer = source.begin();
+        CowVector<int> v(std::move(source));
+        assert(v.cbegin() == buffer && v.Size() == SIZE && v.UseCount() == 1);
+
+        // Копия делит буфер, пока её не изменят
+        CowVector<int> snapshot = v;
+        assert(snapshot.cbegin() == buffer && v.UseCount() == 2 && snapshot.IsShared());
+        assert(std::as_const(snapshot)[10] == 10 && snapshot.cbegin() == buffer);
+
+        v[0] = -1;
+        assert(v.cbegin() != buffer && snapshot.cbegin() == buffer);
+        assert(!v.IsShared() && snapshot.UseCount() == 1);
+        assert(v[0] == -1 && std::as_const(snapshot)[0] == 0);
+        // Единственный владелец меняет буфер на месте
+        const int* own = v.cbegin();
+        v.PushBack(7);
+        v[1] = -2;
+        assert(std::as_const(v)[SIZE] == 7 && v.Size() == SIZE + 1 && (own == v.cbegin() || v.Capacity() > SIZE));
+
+        CowVector<int> copy = snapshot;
+        copy.Erase(copy.cbegin() + 1, copy.cbegin() + 11);
+        copy.Insert(copy.cbegin(), 42);
+        assert(copy.Size() == SIZE - 9 && std::as_const(copy)[0] == 42 && std::as_const(copy)[2] == 11);
+        assert(snapshot.Size() == SIZE && std::as_const(snapshot)[1] == 1);
+
+        // Элемент разделяемого блока в аргументе переживает копирование
+        CowVector<int> alias = snapshot;
+        alias.PushBack(std::as_const(alias)[SIZE - 1]);
+        assert(std::as_const(alias)[SIZE] == static_cast<int>(SIZE - 1));
+
+        alias = snapshot;
+        alias.Clear();
+        assert(alias.Size() == 0 && snapshot.Size() == SIZE && snapshot.UseCount() == 1);
+        CowVector<int> empty;
+        CowVector<int> empty_copy = empty;
+        assert(empty_copy.UseCount() == 0 && empty_copy.cbegin() == empty_copy.cend());
+        empty_copy.EmplaceBack(1);
+        assert(empty_copy.Size() == 1 && empty.Size() == 0);
+    }
+    {
+        // Снимки раздаются потокам и меняются независимо
+        Vector<std::string> source;
+        for (size_t i = 0; i < SIZE; ++i) {
+            source.PushBack(std::to_string(i));
+        }
+        const CowVector<std::string> config(std::move(source));
+        std::atomic<bool> ok{true};
+        std::thread readers[4];
+        for (size_t t = 0; t < 4; ++t) {
+            readers[t] = std::thread([&config, &ok, t] {
+                for (int round = 0; round < 50; ++round) {
+                    CowVector<std::string> snapshot = config;
+                    if (snapshot.Size() != SIZE || snapshot.cbegin()[t] != std::to_string(t)) {
+                        ok = false;
+                    }
+                    if (round % 10 == 0) {
+                        snapshot[t] = "changed";
+                        snapshot.PushBack("tail");
+                    }
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(ok && config.UseCount() == 1 && config[0] == "0");
+    }
+    {
+        // Исключение при копировании блока оставляет оба вектора нетронутыми
+        Obj::ResetCounters();
+        Vector<Obj> source(10);
+        CowVector<Obj> v(std::move(source));
+        CowVector<Obj> snapshot = v;
+        Obj bad;
+        bad.throw_on_copy = true;
+        const int alive = Obj::GetAliveObjectCount();
+        try {
+            v.PushBack(bad);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.UseCount() == 2 && v.cbegin() == snapshot.cbegin() && v.Size() == 10);
+        assert(Obj::GetAliveObjectCount() == alive);
+    }
+}
+
+void Test28() {
+    {
+        // Каждая версия хранит своё содержимое, сколько бы версий ни породили от неё
+        const size_t SIZE = 1100;
+        Vector<PersistentVector<int>> versions;
+        versions.PushBack(PersistentVector<int>());
+        for (size_t i = 0; i < SIZE; ++i) {
+            versions.PushBack(versions[i].PushBack(static_cast<int>(i)));
+        }
+        for (size_t version = 0; version <= SIZE; version += 7) {
+            assert(versions[version].Size() == version);
+            for (size_t i = 0; i < version; ++i) {
+                assert(versions[version][i] == static_cast<int>(i));
+            }
+        }
+
+        const PersistentVector<int>& full = versions[SIZE];
+        const PersistentVector<int> changed = full.Set(5, -5).Set(SIZE - 1, -1).Set(1000, -1000);
+        assert(changed[5] == -5 && changed[SIZE - 1] == -1 && changed[1000] == -1000);
+        assert(full[5] == 5 && full[SIZE - 1] == static_cast<int>(SIZE - 1) && full[1000] == 1000);
+
+        // PopBack через границы хвоста и уровней дерева совпадает с ранними версиями
+        PersistentVector<int> popped = changed;
+        for (size_t size = SIZE; size > 0; --size) {
+            popped = popped.PopBack();
+            assert(popped.Size() == size - 1);
+            if (size % 31 == 0 || size == 1025 || size == 1057 || size == 33) {
+                Vector<int> expected = versions[size - 1].ToVector();
+                if (size - 1 > 5) {
+                    expected[5] = -5;
+                }
+                if (size - 1 > 1000) {
+                    expected[1000] = -1000;
+                }
+                size_t i = 0;
+                for (int value : popped) {
+                    assert(value == expected[i++]);
+                }
+                assert(i == expected.Size());
+            }
+        }
+        assert(popped.begin() == popped.end());
+    }
+    {
+        // Пакетное построение на месте и обмен с Vector
+        const size_t SIZE = 40000;
+        Vector<std::string> source;
+        for (size_t i = 0; i < SIZE; ++i) {
+            source.PushBack(std::to_string(i));
+        }
+        const PersistentVector<std::string> base(source);
+        assert(base.Size() == SIZE && base[SIZE - 1] == std::to_string(SIZE - 1));
+
+        PersistentVector<std::string>::Transient batch = base.AsTransient();
+        for (size_t i = 0; i < SIZE; i += 100) {
+            batch.Set(i, "x");
+        }
+        for (size_t i = 0; i < 1000; ++i) {
+            batch.PopBack();
+        }
+        batch.PushBack("tail");
+        const PersistentVector<std::string> edited = batch.Persistent();
+        assert(batch.Size() == 0);
+        batch.PushBack("reused");
+        assert(edited.Size() == SIZE - 999 && edited[0] == "x" && edited[100] == "x" && edited[101] == "101");
+        assert(edited[SIZE - 1000] == "tail" && base[0] == "0" && base[SIZE - 1] == std::to_string(SIZE - 1));
+
+        const Vector<std::string> back = base.ToVector();
+        assert(back.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(back[i] == source[i]);
+        }
+        const PersistentVector<std::string> moved(std::move(source));
+        assert(moved.Size() == SIZE && moved[123] == "123");
+    }
+    {
+        // Версии порождаются из разных потоков
+        const PersistentVector<int> shared = PersistentVector<int>(Vector<int>(5000));
+        std::thread writers[4];
+        for (size_t t = 0; t < 4; ++t) {
+            writers[t] = std::thread([&shared, t] {
+                PersistentVector<int> local = shared;
+                for (int i = 0; i < 1000; ++i) {
+                    local = local.Set(static_cast<size_t>(i) * 5 % 5000, static_cast<int>(t)).PushBack(i);
+                }
+                assert(local.Size() == 6000 && local[5999] == 999);
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        assert(shared.Size() == 5000 && shared[0] == 0 && shared[4995] == 0);
+    }
+}
+
+void Test29() {
+    const size_t SIZE = 10000;
+    {
+        // Неперемещаемые элементы: рост не трогает уже созданные
+        struct Guarded {
+            explicit Guarded(int value)
+                    : value(value) {
+            }
+            std::mutex mutex;
+            int value;
+            char payload[1000] = {};
+        };
+        SegmentedVector<Guarded> v;
+        static_assert(decltype(v)::kChunkSize == 16);
+        // Блок не меньше 4 КиБ и тогда, когда 4096 не делится на размер элемента
+        struct Triple {
+            char bytes[24];
+        };
+        static_assert(detail::DefaultChunkSize<Triple>() == 256);
+        static_assert(detail::DefaultChunkSize<int>() == 1024);
+        Vector<Guarded*> addresses;
+        for (size_t i = 0; i < SIZE; ++i) {
+            Guarded& item = v.EmplaceBack(static_cast<int>(i));
+            addresses.PushBack(&item);
+        }
+        assert(v.Size() == SIZE && v.Capacity() == (SIZE + 15) / 16 * 16);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(&v[i] == addresses[i] && v[i].value == static_cast<int>(i));
+        }
+        std::lock_guard lock(v[SIZE / 2].mutex);
+        v.PopBack();
+        v.ShrinkToFit();
+        assert(v.Capacity() == (SIZE + 14) / 16 * 16 && &v[SIZE - 2] == addresses[SIZE - 2]);
+    }
+    {
+        Obj::ResetCounters();
+        SegmentedVector<Obj, 64> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.Resize(SIZE + 100);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+
+        SegmentedVector<Obj, 64> copy(v);
+        assert(copy.Size() == SIZE && copy[SIZE - 1].id == static_cast<int>(SIZE - 1));
+        v.Clear();
+        assert(v.Size() == 0 && Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+        v = std::move(copy);
+        assert(v.Size() == SIZE && copy.Size() == 0);
+    }
+    {
+        // Итераторы произвольного доступа работают со стандартными алгоритмами
+        SegmentedVector<int, 32> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>((i * 7919) % SIZE));
+        }
+        std::sort(v.begin(), v.end());
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+        const auto& cv = v;
+        assert(std::lower_bound(cv.begin(), cv.end(), 4321) - cv.begin() == 4321);
+        SegmentedVector<int, 32>::const_iterator it = v.begin() + 10;
+        assert(*it == 10 && it[5] == 15 && cv.end() - it == static_cast<std::ptrdiff_t>(SIZE - 10));
+    }
+}
+
+void Test30() {
+    {
+        constexpr StaticVector<Entry, 16> TABLE = MakeTable();
+        static_assert(TABLE.Size() == 16 && TABLE[0].key == -1 && TABLE[1].key == 0 && TABLE[2].key == 9);
+        static_assert(TABLE[8].key == 100 && TABLE[9].tag == '-' && TABLE.Capacity() == 16);
+        static_assert(sizeof(StaticVector<int, 16>) == 16 * sizeof(int) + sizeof(size_t));
+
+        StaticVector<uint8_t, 4> packet;
+        assert(packet.TryPushBack(1) && packet.TryPushBack(2) && packet.TryPushBack(3) && packet.TryPushBack(4));
+        assert(!packet.TryPushBack(5) && packet.Size() == 4);
+        try {
+            packet.Insert(packet.begin(), 0);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(packet.Size() == 4 && packet[0] == 1 && packet[3] == 4);
+
+        StaticVector<uint8_t, 16> buffer(4, default_init);
+        Span<uint8_t> tail = buffer.AppendUninitialized(4);
+        tail[0] = 7;
+        buffer.ResizeDefaultInit(buffer.Size() + 1);
+        assert(buffer.Size() == 9 && buffer[4] == 7 && tail.Data() == buffer.Data() + 4);
+    }
+    {
+        StaticVector<int, 4> sited;
+        sited.EmplaceBackAt(CallSite::Current(), 2);
+        sited.EmplaceAt(CallSite::Current(), sited.cbegin(), 1);
+        assert(sited.Size() == 2 && sited[0] == 1 && sited[1] == 2);
+        CheckStaticVectorMatchesVector<int>([](int i) {
+            return i;
+        });
+        CheckStaticVectorMatchesVector<std::string>([](int i) {
+            return std::string(20, static_cast<char>('a' + i % 26));
+        });
+        CheckStaticVectorSurface<StaticVector<int, 8>>([](int i) {
+            return i;
+        });
+        CheckStaticVectorSurface<StaticVector<std::string, 8>>([](int i) {
+            return i == 0 ? std::string() : std::string(20, static_cast<char>('a' + i));
+        });
+    }
+    {
+        // Нетривиальные T ведут себя как Vector и не обращаются к аллокатору
+        StaticVector<std::string, 4> names;
+        names.PushBack("b");
+        names.Emplace(names.begin(), "a");
+        names.EmplaceBack(3, 'c');
+        assert(names.Size() == 3 && names[0] == "a" && names[1] == "b" && names[2] == "ccc");
+        assert(names.TryPushBack(names[0]) && !names.TryPushBack("e") && names.TryEmplaceBack("f") == nullptr);
+        try {
+            names.PushBack("overflow");
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(names.Size() == 4 && names[3] == "a" && names.Capacity() == 4);
+        names.Erase(names.begin() + 1);
+        assert(names.Size() == 3 && names[1] == "ccc");
+
+        StaticVector<std::string, 4> copy = names;
+        StaticVector<std::string, 4> moved = std::move(names);
+        assert(copy.Size() == 3 && moved.Size() == 3 && moved[2] == "a");
+        moved.Swap(copy);
+        moved.ShrinkToFit();
+        assert(moved.Capacity() == 4 && moved[0] == "a");
+        try {
+            StaticVector<std::string, 4> too_big(5);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+    }
+    {
+        Obj::ResetCounters();
+        StaticVector<Obj, 8> v(8);
+        assert(Obj::num_default_constructed == 8);
+        try {
+            v.EmplaceBack(1);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == 8 && Obj::GetAliveObjectCount() == 8 && Obj::num_moved == 0);
+    }
+}
+
+void Test31() {
+    {
+        // Без проверок итераторы — указатели, а проверки не занимают места в векторе
+        static_assert(std::is_same_v<Vector<int>::iterator, int*>);
+        static_assert(std::is_same_v<CheckedVector<int>::iterator, int*>);
+        static_assert(sizeof(CheckedVector<int, IteratorChecks>) == sizeof(Vector<int>) + sizeof(uint64_t));
+        static_assert(sizeof(CheckedVector<int>) == sizeof(Vector<int>));
+        static_assert(noexcept(std::declval<Vector<int>&>()[0]));
+    }
+    {
+        CheckedVector<int, ThrowingIteratorChecks> v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(i);
+        }
+        assert(Violates([&] { (void)v[5]; }));
+        assert(Violates([&] { (void)std::as_const(v)[100]; }));
+        assert(Violates([&] { v.Erase(v.cend()); }));
+        assert(Violates([&] { v.Erase(v.begin() + 3, v.begin() + 1); }));
+        assert(Violates([&] { (void)*v.end(); }));
+        assert(Violates([&] { (void)(v.begin() - 1); }));
+        assert(v.Size() == 5 && v[4] == 4);
+
+        // Итератор другого вектора или созданный по умолчанию
+        CheckedVector<int, ThrowingIteratorChecks> other(5);
+        assert(Violates([&] { v.Insert(other.begin(), 1); }));
+        assert(Violates([&] { (void)(v.begin() == other.begin()); }));
+        assert(Violates([&] { (void)*CheckedVector<int, ThrowingIteratorChecks>::iterator(); }));
+
+        // Итератор, полученный до перевыделения
+        auto it = v.begin() + 2;
+        CheckedVector<int, ThrowingIteratorChecks>::const_iterator cit = it;
+        assert(*it == 2 && *cit == 2 && cit == it);
+        v.Reserve(v.Capacity() * 2);
+        assert(Violates([&] { (void)*it; }));
+        assert(Violates([&] { ++cit; }));
+        assert(Violates([&] { v.Erase(it); }));
+
+        it = v.begin() + 2;
+        v.Swap(other);
+        assert(Violates([&] { (void)*it; }));
+        v.Swap(other);
+        it = v.Insert(v.begin() + 2, 42);
+        assert(*it == 42 && v.Size() == 6);
+        it = v.Erase(it);
+        assert(*it == 2 && v.Size() == 5);
+    }
+    {
+        // Проверяемые итераторы годятся для стандартных алгоритмов и функций над Vector
+        CheckedVector<int, ThrowingIteratorChecks> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack((i * 37) % 100);
+        }
+        std::sort(v.begin(), v.end());
+        assert(std::is_sorted(v.cbegin(), v.cend()) && v[0] == 0 && v[99] == 99);
+        assert(std::lower_bound(v.begin(), v.end(), 50) - v.begin() == 50);
+        assert(EraseIf(v, [](int x) { return x % 2 == 1; }) == 50 && v.Size() == 50);
+        assert(*MaxElement(v) == 98 && Count(v, 4) == 1);
+
+        std::vector<int> extra = {-1, -2, -3};
+        v.Insert(v.begin(), extra.begin(), extra.end());
+        v.Append(v.begin() + 3, v.begin() + 5);
+        assert(v.Size() == 55 && v[0] == -1 && v[3] == 0 && v[53] == 0 && v[54] == 2);
+
+        CheckedVector<int, ThrowingIteratorChecks> moved = std::move(v);
+        auto last = moved.end() - 1;
+        assert(*last == 2);
+        v = std::move(moved);
+        assert(Violates([&] { (void)*last; }));
+    }
+    {
+        // Гарантии исключений не зависят от режима проверок
+        Obj::ResetCounters();
+        CheckedVector<Obj, ThrowingIteratorChecks> v(3);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 3 && Obj::GetAliveObjectCount() == 3);
+    }
+}
+
+void Test32() {
+    {
+        // Сверка с std::map на случайных ключах: одиночные вставки, пакеты с повторами, удаления
+        std::map<int, int> expected;
+        FlatMap<int, int> map;
+        uint32_t seed = 12345;
+        auto next = [&seed] {
+            seed = seed * 1664525 + 1013904223;
+            return static_cast<int>(seed >> 22);
+        };
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 50; ++i) {
+                const int key = next();
+                assert(map.TryEmplace(key, i).second == expected.emplace(key, i).second);
+            }
+            std::vector<std::pair<int, int>> batch;
+            for (int i = 0; i < 200; ++i) {
+                batch.emplace_back(next(), -i);
+            }
+            map.InsertRange(batch.begin(), batch.end());
+            for (const auto& [key, value] : batch) {
+                expected.emplace(key, value);
+            }
+            for (int i = 0; i < 30; ++i) {
+                const int key = next();
+                assert(map.Erase(key) == expected.erase(key));
+            }
+            assert(map.Size() == expected.size());
+            assert(std::equal(map.begin(), map.end(), expected.begin(), [](const auto& lhs, const auto& rhs) {
+                return lhs.first == rhs.first && lhs.second == rhs.second;
+            }));
+        }
+        for (int key = -1; key <= 1024; ++key) {
+            const auto it = expected.lower_bound(key);
+            const size_t index = std::distance(expected.begin(), it);
+            assert(map.LowerBound(key) - map.begin() == static_cast<std::ptrdiff_t>(index));
+            assert(map.Contains(key) == (it != expected.end() && it->first == key));
+            assert(map.UpperBound(key) - map.begin()
+                   == std::distance(expected.begin(), expected.upper_bound(key)));
+        }
+        const int first_key = expected.begin()->first;
+        map[first_key] += 100;
+        assert(map.At(first_key) == expected.begin()->second + 100 && (*map.Find(first_key)).second == map[first_key]);
+        try {
+            (void)std::as_const(map).At(-5);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+        assert(map.Find(-5) == map.end() && map[-5] == 0 && (*map.begin()).first == -5);
+    }
+    {
+        // Пересборка без копирования: буферы забираются и возвращаются с теми же адресами
+        FlatMap<int, std::string> map;
+        map.Reserve(4);
+        map.Insert({3, "c"});
+        map.Insert({1, "a"});
+        assert(!map.Insert({1, "x"}).second && map.At(1) == "a");
+        const int* keys = map.Keys().Data();
+        auto parts = map.Extract();
+        assert(map.Size() == 0 && parts.keys.Data() == keys && parts.values[1] == "c");
+        parts.keys.PushBack(7);
+        parts.values.PushBack("g");
+        map.Replace(std::move(parts.keys), std::move(parts.values));
+        assert(map.Size() == 3 && map.Keys().Data() == keys && map.At(7) == "g");
+
+        FlatSet<std::string> set(Vector<std::string>{});
+        std::vector<std::string> words = {"pear", "apple", "fig", "apple", "kiwi", "fig"};
+        set.InsertRange(words.begin(), words.end());
+        assert(set.Size() == 4 && set.Keys()[0] == "apple" && set.Keys()[3] == "pear");
+        assert(set.Insert("banana").second && !set.Insert("kiwi").second && *set.Find("banana") == "banana");
+        assert(set.Erase("fig") == 1 && !set.Contains("fig") && set.Size() == 4);
+        assert(*set.LowerBound("c") == "kiwi" && set.UpperBound("pear") == set.end());
+        Vector<std::string> extracted = set.Extract();
+        assert(extracted.Size() == 4 && set.Size() == 0);
+        set.Replace(std::move(extracted));
+        assert(std::is_sorted(set.begin(), set.end()) && set.Contains("apple"));
+    }
+    {
+        // Копирование значения бросило посреди пакета: отображение не меняется
+        FlatMap<int, Obj> map;
+        map.TryEmplace(5, 50);
+        map.TryEmplace(1, 10);
+        std::vector<std::pair<int, Obj>> batch;
+        for (int i = 0; i < 8; ++i) {
+            batch.emplace_back(10 - i, Obj(i));
+        }
+        batch[5].second.throw_on_copy = true;
+        Obj::ResetCounters();
+        try {
+            map.InsertRange(batch.begin(), batch.end());
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(map.Size() == 2 && map.At(1).id == 10 && map.At(5).id == 50 && Obj::GetAliveObjectCount() == 0);
+        batch[5].second.throw_on_copy = false;
+        map.InsertRange(batch.begin(), batch.end());
+        assert(map.Size() == 9 && map.At(5).id == 50 && map.At(10).id == 0 && map.Keys()[8] == 10);
+    }    {
+        // Ключи с небросающим перемещением не теряются, если бросило копирование значения
+        // на любом шаге InsertRange, включая слияние
+        const std::string a(100, 'a');
+        const std::string b(100, 'b');
+        const std::vector<std::pair<std::string, CopyOnlyObj>> batch{{"d", CopyOnlyObj(4)}, {"c", CopyOnlyObj(3)}};
+        for (int countdown = 1;; ++countdown) {
+            FlatMap<std::string, CopyOnlyObj> map;
+            map.TryEmplace(b, 2);
+            map.TryEmplace(a, 1);
+            CopyOnlyObj::copy_throw_countdown = countdown;
+            try {
+                map.InsertRange(batch.begin(), batch.end());
+            } catch (const std::runtime_error&) {
+                assert(map.Size() == 2 && map.Keys()[0] == a && map.Keys()[1] == b);
+                assert(map.At(a).id == 1 && map.At(b).id == 2);
+                continue;
+            }
+            CopyOnlyObj::copy_throw_countdown = 0;
+            assert(countdown > 4 && map.Size() == 4 && map.Keys()[0] == a && map.Keys()[2] == "c");
+            assert(map.At("d").id == 4 && map.At(b).id == 2);
+            break;
+        }
+    }
+}
+
+void Test33() {
+    using Traced = TracedStats<VectorStats<TracedStatsTag>>;
+    SetReallocationObserver(RecordReallocation);
+    {
+        traced_events.clear();
+        Vector<int, std::allocator<int>, DoublingGrowth, Traced> v;
+        v.Reserve(4); const unsigned reserve_line = __LINE__;
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(i);
+        }
+        v.PushBack(4); const unsigned push_line = __LINE__;
+        v.EmplaceBack(5);
+        v.Resize(100); const unsigned resize_line = __LINE__;
+        assert(traced_events.size() == 3);
+
+        const ReallocationEvent& reserve = traced_events[0];
+        assert(reserve.old_capacity == 0 && reserve.new_capacity == 4 && reserve.bytes_moved == 0);
+        assert(reserve.call_site.line == reserve_line && std::string(reserve.call_site.file).find("main.cpp") != std::string::npos);
+        const ReallocationEvent& push = traced_events[1];
+        assert(push.old_capacity == 4 && push.new_capacity == 8 && push.bytes_moved == 4 * sizeof(int));
+        assert(push.call_site.line == push_line && push.elements_relocated_bitwise == 4);
+        assert(traced_events[2].call_site.line == resize_line && traced_events[2].bytes_moved == 6 * sizeof(int));
+        assert(Traced::Counters().Load().reallocations == 3);
+
+        // У EmplaceBack место вызова неизвестно, EmplaceBackAt и EmplaceAt принимают его явно
+        v.EmplaceBack(6);
+        assert(traced_events.size() == 4 && traced_events[3].call_site.file == nullptr);
+        assert(traced_events[3].old_capacity == 100 && traced_events[3].bytes_moved == 100 * sizeof(int));
+        v.Resize(v.Capacity());
+        v.EmplaceBackAt(CallSite::Current(), 7); const unsigned emplace_back_line = __LINE__;
+        assert(traced_events.size() == 5 && traced_events[4].call_site.line == emplace_back_line);
+        assert(v[v.Size() - 1] == 7);
+        v.Resize(v.Capacity());
+        v.EmplaceAt(CallSite::Current(), v.begin(), 8); const unsigned emplace_line = __LINE__;
+        assert(traced_events.size() == 6 && traced_events[5].call_site.line == emplace_line && v[0] == 8);
+        traced_events.erase(traced_events.begin() + 4, traced_events.end());
+        v.Resize(101);
+        v.PopBack();
+        v.ShrinkToFit(); const unsigned shrink_line = __LINE__;
+        assert(traced_events.size() == 5 && traced_events[4].call_site.line == shrink_line);
+        assert(traced_events[4].new_capacity == 100);
+    }
+    {
+        traced_events.clear();
+        Vector<Obj, std::allocator<Obj>, DoublingGrowth, TracedStats<>> v;
+        v.Resize(10);
+        v.Insert(v.begin(), Obj(1)); const unsigned insert_line = __LINE__;
+        assert(traced_events.size() == 2 && traced_events[1].call_site.line == insert_line);
+        assert(traced_events[1].elements_moved == 10 && traced_events[1].bytes_moved == 10 * sizeof(Obj));
+
+        // Слишком быстрые перевыделения наблюдателю не передаются
+        SetReallocationObserver(RecordReallocation, UINT64_MAX);
+        v.Reserve(1000);
+        SetReallocationObserver(nullptr);
+        v.Reserve(2000);
+        assert(traced_events.size() == 2 && v.Capacity() == 2000);
+    }
+}
+
+void Test34() {
+    {
+        IncrementalVector<int> v;
+        for (int i = 0; i < 1024; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 1024 && !v.IsMigrating());
+        // Рост переносит старые элементы по kMigrationStep за вставку
+        v.PushBack(1024);
+        assert(v.Capacity() == 2048 && v.PendingMigration() == 1024);
+        for (int i = 1025; i < 1100; ++i) {
+            const size_t pending = v.PendingMigration();
+            v.PushBack(i);
+            assert(v.PendingMigration() == pending - decltype(v)::kMigrationStep);
+        }
+        assert(v.IsMigrating() && v.Size() == 1100);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+        v[0] = -1;
+        v[1000] = -2;
+        assert(v[0] == -1 && v[1000] == -2);
+        v[0] = 0;
+        v[1000] = 1000;
+        int expected = 0;
+        for (int value : std::as_const(v)) {
+            assert(value == expected++);
+        }
+        assert(v.end() - v.begin() == 1100);
+
+        v.AdvanceMigration(100);
+        assert(v.PendingMigration() == 1024 - 150 - 100);
+        v.FinishMigration();
+        assert(!v.IsMigrating() && v[500] == 500);
+        // Новый буфер заполняется уже после окончания переноса
+        while (v.Size() < 2048) {
+            v.PushBack(static_cast<int>(v.Size()));
+        }
+        assert(!v.IsMigrating() && v.Capacity() == 2048);
+        v.Reserve(5000);
+        assert(!v.IsMigrating() && v.Capacity() == 5000 && v[2047] == 2047);
+    }
+    {
+        // Удаление ещё не перенесённых элементов сокращает перенос
+        Obj::ResetCounters();
+        IncrementalVector<Obj, 1> v;
+        for (int i = 0; i < 9; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.IsMigrating() && v.PendingMigration() == 8 && v.Capacity() == 16);
+        v.PopBack();
+        assert(v.PendingMigration() == 7 && v.Size() == 8);
+        v.PopBack();
+        v.PopBack();
+        assert(v.Size() == 6 && v.PendingMigration() == 3);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i].id == static_cast<int>(i));
+        }
+        while (v.IsMigrating()) {
+            v.PopBack();
+        }
+        assert(v.Size() == 4 && v[3].id == 3);
+        assert(Obj::GetAliveObjectCount() == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        IncrementalVector<Obj> v;
+        for (int i = 0; i < 33; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.IsMigrating());
+        IncrementalVector<Obj> copy(v);
+        assert(!copy.IsMigrating() && copy.Size() == 33 && copy[5].id == 5 && copy[32].id == 32);
+
+        // Бросившее копирование не меняет элементы; сделанный до него шаг переноса сохраняется
+        IncrementalVector<Obj> source;
+        source.EmplaceBack(7).throw_on_copy = true;
+        const size_t pending = v.PendingMigration();
+        try {
+            v.PushBack(source[0]);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 33 && v.PendingMigration() == pending - 2 && v[0].id == 0);
+
+        IncrementalVector<Obj> moved(std::move(v));
+        assert(v.Size() == 0 && !v.IsMigrating() && moved.IsMigrating() && moved[20].id == 20);
+        moved.Swap(copy);
+        assert(!moved.IsMigrating() && copy.IsMigrating() && copy[1].id == 1);
+        copy = moved;
+        assert(!copy.IsMigrating() && copy.Size() == 33);
+        moved.Clear();
+        assert(moved.Size() == 0 && !moved.IsMigrating());
+        assert(Obj::GetAliveObjectCount() == 33 + 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Аргумент, ссылающийся на ещё не перенесённый элемент, переживает шаг переноса
+        // и освобождение старого буфера
+        IncrementalVector<std::string> v;
+        for (int i = 0; i < 16; ++i) {
+            v.PushBack(std::string(32, static_cast<char>('a' + i)));
+        }
+        v.PushBack(v[15]);
+        assert(v.IsMigrating() && v[16] == v[15]);
+        for (size_t i = 1; v.IsMigrating(); ++i) {
+            v.PushBack(v[v.Size() - 17]);
+            assert(v[v.Size() - 1] == std::string(32, static_cast<char>('a' + i - 1)));
+        }
+        v.EmplaceBack(v[3], 1, 5);
+        assert(v.Size() == 26 && v[25] == std::string(5, 'd'));
+    }
+}
+
 int main() {
     try {
         Test1();
@@ -387,6 +2689,35 @@ int main() {
         Test3();
         Test4();
         Test5();
+        Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
     } catch (const std::exception &e) {
         std::cerr << e.what() << std::endl;
     }
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Аллокатор поверх malloc/realloc, умеющий расширять буфер на месте.
+// Память всегда от malloc, поэтому буфер из C-библиотеки можно передать в Vector::Adopt,
+// а полученный из Vector::Release — освободить через free. Большие буферы glibc сама
+// отображает страницами и растит в realloc через mremap.
+// Метод reallocate используется Vector только для побайтово переносимых типов.
+template <typename T>
+class MallocAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MallocAllocator supports only default alignment");
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        void* p = std::malloc(n * sizeof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        std::free(static_cast<void*>(p));
+    }
+
+    // Возвращает буфер на new_n элементов с побайтовой копией первых min(old_n, new_n) объектов.
+    // При успехе p недействителен; при неудаче бросает std::bad_alloc и p остаётся нетронутым.
+    T* reallocate(T* p, size_t, size_t new_n) {
+        void* q = std::realloc(static_cast<void*>(p), new_n * sizeof(T));
+        if (q == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(q);
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+#ifdef __linux__
+
+// Как MallocAllocator, но буферы от kMmapThreshold байт отображаются отдельными страницами
+// независимо от порога malloc и растут через mremap, так что при росте ядро переставляет
+// страницы, а не копирует их содержимое. Такие буферы освобождаются только через munmap,
+// поэтому обмениваться ими с C-кодом через Adopt/Release нельзя.
+template <typename T>
+class MmapAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MmapAllocator supports only default alignment");
+
+    static constexpr size_t kMmapThreshold = size_t{1} << 20;
+
+    MmapAllocator() = default;
+
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        const size_t bytes = n * sizeof(T);
+        if (IsMapped(bytes)) {
+            return static_cast<T*>(Map(bytes));
+        }
+        void* p = std::malloc(bytes);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (IsMapped(n * sizeof(T))) {
+            munmap(p, RoundToPages(n * sizeof(T)));
+            return;
+        }
+        std::free(static_cast<void*>(p));
+    }
+
+    // Возвращает буфер на new_n элементов с побайтовой копией первых min(old_n, new_n) объектов.
+    // При успехе p недействителен; при неудаче бросает std::bad_alloc и p остаётся нетронутым.
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = new_n * sizeof(T);
+        if (IsMapped(old_bytes) && IsMapped(new_bytes)) {
+            void* q = mremap(static_cast<void*>(p), RoundToPages(old_bytes), RoundToPages(new_bytes), MREMAP_MAYMOVE);
+            if (q == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(q);
+        }
+        if (IsMapped(old_bytes) || IsMapped(new_bytes)) {
+            T* q = allocate(new_n);
+            std::memcpy(static_cast<void*>(q), static_cast<const void*>(p), std::min(old_bytes, new_bytes));
+            deallocate(p, old_n);
+            return q;
+        }
+        void* q = std::realloc(static_cast<void*>(p), new_bytes);
+        if (q == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(q);
+    }
+
+    template <typename U>
+    bool operator==(const MmapAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const MmapAllocator<U>&) const noexcept {
+        return false;
+    }
+
+private:
+    static bool IsMapped(size_t bytes) noexcept {
+        return bytes >= kMmapThreshold;
+    }
+
+    static size_t RoundToPages(size_t bytes) noexcept {
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) / page * page;
+    }
+
+    static void* Map(size_t bytes) {
+        void* p = mmap(nullptr, RoundToPages(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+};
+
+#endif
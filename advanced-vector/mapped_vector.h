@@ -0,0 +1,363 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class MapMode {
+    // Файл создаётся при отсутствии, изменения попадают в файл
+    kReadWrite,
+    // Файл только читается; процессы, открывшие один файл, делят страничный кеш
+    kReadOnly,
+};
+
+// Вектор побайтово копируемых записей, хранящихся прямо в отображённом файле.
+// Открытие существующего файла не разбирает его: записи доступны сразу после mmap.
+// Файл начинается с заголовка kHeaderBytes байт, за которым идут Capacity() записей;
+// размер хранится в заголовке и обновляется при каждом изменении.
+// В режиме kReadOnly доступ есть только через константные методы: изменяющие методы,
+// а также неконстантные operator[], begin и end бросают std::logic_error.
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires a trivially copyable T");
+
+    static constexpr size_t kHeaderBytes = 64;
+
+    static_assert(alignof(T) <= kHeaderBytes, "MappedVector supports alignment up to the header size");
+
+    using value_type = T;
+    using iterator = typename Vector<T>::iterator;
+    using const_iterator = typename Vector<T>::const_iterator;
+
+    // Вектор без файла: пригоден только как цель перемещения
+    MappedVector() = default;
+
+    explicit MappedVector(const std::string& path, MapMode mode = MapMode::kReadWrite)
+            : read_only_(mode == MapMode::kReadOnly) {
+        fd_ = read_only_ ? open(path.c_str(), O_RDONLY | O_CLOEXEC) : open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: cannot open " + path);
+        }
+        try {
+            Map(path);
+        } catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector& other) = delete;
+    MappedVector& operator=(const MappedVector& rhs) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+            : fd_(std::exchange(other.fd_, -1))
+            , base_(std::exchange(other.base_, nullptr))
+            , mapped_bytes_(std::exchange(other.mapped_bytes_, 0))
+            , read_only_(other.read_only_) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            base_ = std::exchange(rhs.base_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+            read_only_ = rhs.read_only_;
+        }
+        return *this;
+    }
+
+    // Отображение снимается без msync: ядро всё равно запишет грязные страницы в файл
+    ~MappedVector() {
+        Close();
+    }
+
+    iterator begin() {
+        CheckWritable();
+        return Data();
+    }
+    iterator end() {
+        CheckWritable();
+        return Data() + Size();
+    }
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + Size();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return base_ != nullptr ? static_cast<size_t>(GetHeader()->size) : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return base_ != nullptr ? (mapped_bytes_ - kHeaderBytes) / sizeof(T) : 0;
+    }
+
+    bool IsReadOnly() const noexcept {
+        return read_only_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    T& operator[](size_t index) {
+        assert(index < Size());
+        CheckWritable();
+        return Data()[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        CheckWritable();
+        if (new_capacity > Capacity()) {
+            Remap(new_capacity);
+        }
+    }
+
+    // Новые записи заполняются нулями: файл растёт через ftruncate
+    void Resize(size_t new_size) {
+        CheckWritable();
+        Reserve(new_size);
+        if (new_size > Size()) {
+            std::memset(static_cast<void*>(Data() + Size()), 0, (new_size - Size()) * sizeof(T));
+        }
+        SetSize(new_size);
+    }
+
+    // Обрезает файл до размера, округлённого вверх до страницы
+    void ShrinkToFit() {
+        CheckWritable();
+        if (Size() < Capacity()) {
+            Remap(Size());
+        }
+    }
+
+    void Clear() {
+        CheckWritable();
+        if (base_ != nullptr) {
+            SetSize(0);
+        }
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return *Emplace(end(), std::forward<Args>(args)...);
+    }
+
+    void PopBack() {
+        CheckWritable();
+        if (Size() > 0) {
+            SetSize(Size() - 1);
+        }
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        CheckWritable();
+        assert(pos >= begin() && pos <= end());
+        const size_t position = pos - begin();
+        // Аргументы могут ссылаться на записи, поэтому значение строится до сдвига и перевыделения
+        const T value = MakeValue(std::forward<Args>(args)...);
+        if (Size() == Capacity()) {
+            Remap(GrowthPolicy::NextCapacity(Capacity(), Size() + 1, sizeof(T)));
+        }
+        T* gap = Data() + position;
+        std::memmove(static_cast<void*>(gap + 1), static_cast<const void*>(gap), (Size() - position) * sizeof(T));
+        std::memcpy(static_cast<void*>(gap), static_cast<const void*>(&value), sizeof(T));
+        SetSize(Size() + 1);
+        return gap;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Erase(const_iterator pos) {
+        assert(pos >= begin() && pos < end());
+        return Erase(pos, pos + 1);
+    }
+
+    iterator Erase(const_iterator first, const_iterator last) {
+        CheckWritable();
+        assert(first >= begin() && first <= last && last <= end());
+        T* gap = Data() + (first - begin());
+        const size_t count = last - first;
+        std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count),
+                     (end() - last) * sizeof(T));
+        SetSize(Size() - count);
+        return gap;
+    }
+
+    // Сбрасывает изменения на диск; при async только ставит запись в очередь
+    void Sync(bool async = false) {
+        if (base_ != nullptr && !read_only_ && msync(base_, mapped_bytes_, async ? MS_ASYNC : MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: msync failed");
+        }
+    }
+
+private:
+    static constexpr char kMagic[8] = {'A', 'V', 'M', 'A', 'P', 'V', '1', '\0'};
+
+    struct Header {
+        char magic[8];
+        uint64_t element_size;
+        uint64_t size;
+    };
+
+    static_assert(sizeof(Header) <= kHeaderBytes);
+
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    bool read_only_ = false;
+
+    Header* GetHeader() const noexcept {
+        return static_cast<Header*>(base_);
+    }
+
+    T* Data() const noexcept {
+        return base_ != nullptr ? reinterpret_cast<T*>(static_cast<char*>(base_) + kHeaderBytes) : nullptr;
+    }
+
+    // Страницы файла, открытого только для чтения, отображены без PROT_WRITE: запись
+    // через них завершила бы процесс по SIGSEGV, поэтому изменения отклоняются заранее
+    void CheckWritable() const {
+        if (read_only_) {
+            throw std::logic_error("MappedVector: file is mapped read-only");
+        }
+    }
+
+    void SetSize(size_t size) noexcept {
+        assert(!read_only_ && size <= Capacity());
+        GetHeader()->size = size;
+    }
+
+    // Записи — обычно агрегаты без конструктора от args, они инициализируются списком
+    template <typename... Args>
+    static T MakeValue(Args&&... args) {
+        if constexpr (std::is_constructible_v<T, Args&&...>) {
+            return T(std::forward<Args>(args)...);
+        } else {
+            return T{std::forward<Args>(args)...};
+        }
+    }
+
+    static size_t PageSize() noexcept {
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return page;
+    }
+
+    static size_t FileBytes(size_t capacity) noexcept {
+        const size_t bytes = kHeaderBytes + capacity * sizeof(T);
+        return (bytes + PageSize() - 1) / PageSize() * PageSize();
+    }
+
+    void Map(const std::string& path) {
+        struct stat st {};
+        if (fstat(fd_, &st) != 0) {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: cannot stat " + path);
+        }
+        size_t bytes = static_cast<size_t>(st.st_size);
+        const bool created = bytes == 0 && !read_only_;
+        if (created) {
+            bytes = FileBytes(0);
+            Truncate(bytes);
+        }
+        if (bytes < kHeaderBytes) {
+            throw std::runtime_error("MappedVector: " + path + " is not a mapped vector file");
+        }
+
+        const int prot = read_only_ ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* p = mmap(nullptr, bytes, prot, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: cannot map " + path);
+        }
+        base_ = p;
+        mapped_bytes_ = bytes;
+
+        if (created) {
+            std::memcpy(GetHeader()->magic, kMagic, sizeof(kMagic));
+            GetHeader()->element_size = sizeof(T);
+            GetHeader()->size = 0;
+        } else if (std::memcmp(GetHeader()->magic, kMagic, sizeof(kMagic)) != 0
+                   || GetHeader()->element_size != sizeof(T) || GetHeader()->size > Capacity()) {
+            throw std::runtime_error("MappedVector: " + path + " does not hold records of this type");
+        }
+    }
+
+    void Truncate(size_t bytes) {
+        if (ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: ftruncate failed");
+        }
+    }
+
+    // Меняет длину файла и отображения; при росте данные не копируются
+    void Remap(size_t new_capacity) {
+        assert(!read_only_ && base_ != nullptr && new_capacity >= Size());
+        const size_t new_bytes = FileBytes(new_capacity);
+        if (new_bytes == mapped_bytes_) {
+            return;
+        }
+        const bool grows = new_bytes > mapped_bytes_;
+        if (grows) {
+            Truncate(new_bytes);
+        }
+#ifdef __linux__
+        void* p = mremap(base_, mapped_bytes_, new_bytes, MREMAP_MAYMOVE);
+#else
+        void* p = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p != MAP_FAILED) {
+            munmap(base_, mapped_bytes_);
+        }
+#endif
+        if (p == MAP_FAILED) {
+            const int error = errno;
+            if (grows) {
+                // Возвращаем файлу прежнюю длину, чтобы он соответствовал отображению
+                [[maybe_unused]] const int ignored = ftruncate(fd_, static_cast<off_t>(mapped_bytes_));
+            }
+            throw std::system_error(error, std::generic_category(), "MappedVector: cannot remap");
+        }
+        base_ = p;
+        mapped_bytes_ = new_bytes;
+        if (!grows) {
+            Truncate(new_bytes);
+        }
+    }
+
+    void Close() noexcept {
+        if (base_ != nullptr) {
+            munmap(base_, mapped_bytes_);
+            base_ = nullptr;
+            mapped_bytes_ = 0;
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,546 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+
+// Неизменяемый вектор со структурным разделением: 32-ичное префиксное дерево листьев
+// по 32 элемента и отдельный хвостовой лист, как в векторах Clojure.
+// PushBack, Set и PopBack возвращают новую версию за O(log32 n), копируя только путь
+// от корня к изменённому листу; остальные узлы делят все версии. Копия версии стоит O(1).
+// Счётчики ссылок узлов атомарны, поэтому версии можно читать и порождать из разных потоков.
+// Transient меняет дерево на месте, копируя только узлы, которыми он ещё не владеет,
+// и подходит для пакетного построения; Persistent() превращает его обратно в версию.
+template <typename T>
+class PersistentVector {
+public:
+    static constexpr size_t kBits = 5;
+    static constexpr size_t kBranching = size_t{1} << kBits;
+
+    using value_type = T;
+
+    class Transient;
+    class ConstIterator;
+    using const_iterator = ConstIterator;
+
+    PersistentVector() = default;
+
+    template <typename A, typename G, typename S, typename Storage, typename C>
+    explicit PersistentVector(const Vector<T, A, G, S, Storage, C>& source) {
+        Transient builder;
+        for (const T& value : source) {
+            builder.PushBack(value);
+        }
+        *this = builder.Persistent();
+    }
+
+    // Элементы source перемещаются в листья
+    template <typename A, typename G, typename S, typename Storage, typename C>
+    explicit PersistentVector(Vector<T, A, G, S, Storage, C>&& source) {
+        Transient builder;
+        for (T& value : source) {
+            builder.PushBack(std::move(value));
+        }
+        *this = builder.Persistent();
+    }
+
+    PersistentVector(const PersistentVector& other) noexcept = default;
+    PersistentVector(PersistentVector&& other) noexcept = default;
+    PersistentVector& operator=(const PersistentVector& rhs) noexcept = default;
+    PersistentVector& operator=(PersistentVector&& rhs) noexcept = default;
+
+    size_t Size() const noexcept {
+        return trie_.size;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return trie_.LeafArray(index)[index & (kBranching - 1)];
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(&trie_, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(&trie_, Size());
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] PersistentVector PushBack(T value) const {
+        PersistentVector result(*this);
+        result.trie_.PushBack(std::move(value), kNoEdit);
+        return result;
+    }
+
+    [[nodiscard]] PersistentVector Set(size_t index, T value) const {
+        assert(index < Size());
+        PersistentVector result(*this);
+        result.trie_.Set(index, std::move(value), kNoEdit);
+        return result;
+    }
+
+    [[nodiscard]] PersistentVector PopBack() const {
+        assert(Size() > 0);
+        PersistentVector result(*this);
+        result.trie_.PopBack(kNoEdit);
+        return result;
+    }
+
+    // Изменяемая копия версии; сама версия при изменениях Transient не меняется
+    Transient AsTransient() const {
+        return Transient(trie_);
+    }
+
+    // Копирует элементы в Vector, по листу за раз
+    template <typename Vec = Vector<T>>
+    Vec ToVector() const {
+        Vec result;
+        result.Reserve(Size());
+        for (size_t first = 0; first < Size(); first += kBranching) {
+            const T* leaf = trie_.LeafArray(first);
+            result.Append(leaf, leaf + std::min(kBranching, Size() - first));
+        }
+        return result;
+    }
+
+private:
+    // Узлы, созданные неизменяемыми операциями, не принадлежат никакому Transient
+    static constexpr uint64_t kNoEdit = 0;
+
+    struct Node {
+        explicit Node(bool is_leaf, uint64_t edit) noexcept
+                : leaf(is_leaf)
+                , owner(edit) {
+        }
+
+        std::atomic<size_t> refs{1};
+        const bool leaf;
+        // Transient, которому узел принадлежит и который может менять его на месте
+        const uint64_t owner;
+    };
+
+    struct Branch : Node {
+        explicit Branch(uint64_t edit) noexcept
+                : Node(false, edit) {
+        }
+
+        Node* children[kBranching] = {};
+    };
+
+    struct Leaf : Node {
+        explicit Leaf(uint64_t edit) noexcept
+                : Node(true, edit) {
+        }
+
+        Leaf(const Leaf&) = delete;
+        Leaf& operator=(const Leaf&) = delete;
+
+        ~Leaf() {
+            std::destroy_n(Values(), count);
+        }
+
+        T* Values() noexcept {
+            return reinterpret_cast<T*>(storage);
+        }
+
+        size_t count = 0;
+        alignas(T) unsigned char storage[sizeof(T) * kBranching];
+    };
+
+    static Node* Retain(Node* node) noexcept {
+        if (node != nullptr) {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+
+    // Последняя ссылка освобождает узел и отпускает его детей
+    static void Release(Node* node) noexcept {
+        if (node == nullptr || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        if (node->leaf) {
+            delete static_cast<Leaf*>(node);
+        } else {
+            Branch* branch = static_cast<Branch*>(node);
+            for (Node* child : branch->children) {
+                Release(child);
+            }
+            delete branch;
+        }
+    }
+
+    // Владеющая ссылка на узел, ещё не вставленный в дерево
+    class NodePtr {
+    public:
+        explicit NodePtr(Node* node) noexcept
+                : node_(node) {
+        }
+
+        NodePtr(const NodePtr&) = delete;
+        NodePtr& operator=(const NodePtr&) = delete;
+
+        NodePtr(NodePtr&& other) noexcept
+                : node_(std::exchange(other.node_, nullptr)) {
+        }
+
+        NodePtr& operator=(NodePtr&& rhs) noexcept {
+            PersistentVector::Release(std::exchange(node_, std::exchange(rhs.node_, nullptr)));
+            return *this;
+        }
+
+        ~NodePtr() {
+            PersistentVector::Release(node_);
+        }
+
+        template <typename N = Node>
+        N* Get() const noexcept {
+            return static_cast<N*>(node_);
+        }
+
+        Node* Release() noexcept {
+            return std::exchange(node_, nullptr);
+        }
+
+    private:
+        Node* node_;
+    };
+
+    // Корень — ветвь уровня shift; дерево хранит только полные листья,
+    // последние 1..32 элемента лежат в хвосте. root == nullptr при size <= 32.
+    struct Trie {
+        Trie() = default;
+
+        Trie(const Trie& other) noexcept
+                : size(other.size)
+                , shift(other.shift)
+                , root(Retain(other.root))
+                , tail(Retain(other.tail)) {
+        }
+
+        Trie(Trie&& other) noexcept
+                : size(std::exchange(other.size, 0))
+                , shift(std::exchange(other.shift, kBits))
+                , root(std::exchange(other.root, nullptr))
+                , tail(std::exchange(other.tail, nullptr)) {
+        }
+
+        Trie& operator=(const Trie& rhs) noexcept {
+            Trie copy(rhs);
+            Swap(copy);
+            return *this;
+        }
+
+        Trie& operator=(Trie&& rhs) noexcept {
+            Trie moved(std::move(rhs));
+            Swap(moved);
+            return *this;
+        }
+
+        ~Trie() {
+            Release(root);
+            Release(tail);
+        }
+
+        void Swap(Trie& other) noexcept {
+            std::swap(size, other.size);
+            std::swap(shift, other.shift);
+            std::swap(root, other.root);
+            std::swap(tail, other.tail);
+        }
+
+        size_t TailOffset() const noexcept {
+            return size <= kBranching ? 0 : (size - 1) >> kBits << kBits;
+        }
+
+        // Элементы листа, в котором лежит index
+        const T* LeafArray(size_t index) const noexcept {
+            return const_cast<Trie&>(*this).MutableLeaf(index)->Values();
+        }
+
+        Leaf* MutableLeaf(size_t index) noexcept {
+            if (index >= TailOffset()) {
+                return static_cast<Leaf*>(tail);
+            }
+            Node* node = root;
+            for (size_t level = shift; level > 0; level -= kBits) {
+                node = static_cast<Branch*>(node)->children[(index >> level) & (kBranching - 1)];
+            }
+            return static_cast<Leaf*>(node);
+        }
+
+        static bool Owns(Node* node, uint64_t edit) noexcept {
+            return edit != kNoEdit && node->owner == edit;
+        }
+
+        // Делает узел в slot изменяемым: чужой узел заменяется копией, принадлежащей edit
+        static Branch* EditableBranch(Node*& slot, uint64_t edit) {
+            if (!Owns(slot, edit)) {
+                NodePtr copy(new Branch(edit));
+                Branch* source = static_cast<Branch*>(slot);
+                for (size_t i = 0; i < kBranching; ++i) {
+                    copy.template Get<Branch>()->children[i] = Retain(source->children[i]);
+                }
+                Release(std::exchange(slot, copy.Release()));
+            }
+            return static_cast<Branch*>(slot);
+        }
+
+        static Leaf* EditableLeaf(Node*& slot, uint64_t edit) {
+            if (!Owns(slot, edit)) {
+                NodePtr copy(new Leaf(edit));
+                Leaf* source = static_cast<Leaf*>(slot);
+                Leaf* leaf = copy.template Get<Leaf>();
+                for (; leaf->count < source->count; ++leaf->count) {
+                    new (leaf->Values() + leaf->count) T(source->Values()[leaf->count]);
+                }
+                Release(std::exchange(slot, copy.Release()));
+            }
+            return static_cast<Leaf*>(slot);
+        }
+
+        // Цепочка ветвей до уровня level, ведущая к node
+        static NodePtr NewPath(size_t level, NodePtr node, uint64_t edit) {
+            for (size_t current = kBits; current <= level; current += kBits) {
+                NodePtr branch(new Branch(edit));
+                branch.template Get<Branch>()->children[0] = node.Release();
+                node = std::move(branch);
+            }
+            return node;
+        }
+
+        // Вставляет полный лист на место последнего листа дерева (индексы [size - 32, size))
+        void PushTail(Node*& slot, size_t level, NodePtr& leaf, uint64_t edit) {
+            Branch* node = EditableBranch(slot, edit);
+            Node*& child = node->children[((size - 1) >> level) & (kBranching - 1)];
+            if (level == kBits) {
+                child = leaf.Release();
+            } else if (child != nullptr) {
+                PushTail(child, level - kBits, leaf, edit);
+            } else {
+                child = NewPath(level - kBits, std::move(leaf), edit).Release();
+            }
+        }
+
+        // Отрезает последний лист дерева; возвращает true, если узел в slot опустел
+        bool PopTail(Node*& slot, size_t level, uint64_t edit) {
+            Branch* node = EditableBranch(slot, edit);
+            const size_t index = ((size - 2) >> level) & (kBranching - 1);
+            if (level == kBits || PopTail(node->children[index], level - kBits, edit)) {
+                Release(std::exchange(node->children[index], nullptr));
+            }
+            return index == 0 && node->children[index] == nullptr;
+        }
+
+        // При исключении содержимое не меняется: узлы на пути могли лишь замениться равными копиями
+        void PushBack(T&& value, uint64_t edit) {
+            if (size - TailOffset() < kBranching) {
+                if (tail == nullptr) {
+                    tail = new Leaf(edit);
+                }
+                Leaf* leaf = EditableLeaf(tail, edit);
+                new (leaf->Values() + leaf->count) T(std::move(value));
+                ++leaf->count;
+                ++size;
+                return;
+            }
+
+            // Хвост полон: он уходит в дерево, новый элемент начинает новый хвост
+            NodePtr fresh(new Leaf(edit));
+            new (fresh.template Get<Leaf>()->Values()) T(std::move(value));
+            fresh.template Get<Leaf>()->count = 1;
+            NodePtr full(Retain(tail));
+            if (root == nullptr) {
+                root = new Branch(edit);
+                shift = kBits;
+                static_cast<Branch*>(root)->children[0] = full.Release();
+            } else if ((size >> kBits) > (size_t{1} << shift)) {
+                // Дерево заполнено: новый корень на уровень выше
+                NodePtr path = NewPath(shift, std::move(full), edit);
+                Branch* new_root = new Branch(edit);
+                new_root->children[0] = root;
+                new_root->children[1] = path.Release();
+                root = new_root;
+                shift += kBits;
+            } else {
+                PushTail(root, shift, full, edit);
+            }
+            Release(std::exchange(tail, fresh.Release()));
+            ++size;
+        }
+
+        void Set(size_t index, T&& value, uint64_t edit) {
+            Node** slot = &tail;
+            if (index < TailOffset()) {
+                slot = &root;
+                for (size_t level = shift; level > 0; level -= kBits) {
+                    Branch* node = EditableBranch(*slot, edit);
+                    slot = &node->children[(index >> level) & (kBranching - 1)];
+                }
+            }
+            EditableLeaf(*slot, edit)->Values()[index & (kBranching - 1)] = std::move(value);
+        }
+
+        void PopBack(uint64_t edit) {
+            if (size == 1) {
+                Release(std::exchange(tail, nullptr));
+                size = 0;
+                return;
+            }
+            if (size - TailOffset() > 1) {
+                Leaf* leaf = EditableLeaf(tail, edit);
+                --leaf->count;
+                std::destroy_at(leaf->Values() + leaf->count);
+                --size;
+                return;
+            }
+
+            // В хвосте последний элемент: хвостом становится последний лист дерева
+            NodePtr new_tail(Retain(MutableLeaf(size - 2)));
+            if (PopTail(root, shift, edit)) {
+                Release(std::exchange(root, nullptr));
+                shift = kBits;
+            } else if (shift > kBits && static_cast<Branch*>(root)->children[1] == nullptr) {
+                // У корня остался один ребёнок: дерево становится на уровень ниже
+                Node* child = Retain(static_cast<Branch*>(root)->children[0]);
+                Release(std::exchange(root, child));
+                shift -= kBits;
+            }
+            Release(std::exchange(tail, new_tail.Release()));
+            --size;
+        }
+
+        size_t size = 0;
+        size_t shift = kBits;
+        Node* root = nullptr;
+        Node* tail = nullptr;
+    };
+
+    static uint64_t NextEdit() noexcept {
+        static std::atomic<uint64_t> next{kNoEdit + 1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    explicit PersistentVector(Trie&& trie) noexcept
+            : trie_(std::move(trie)) {
+    }
+
+    Trie trie_;
+
+public:
+    // Изменяемый вектор для пакетных правок. Узлы, созданные им, меняются на месте,
+    // поэтому PushBack обходится без копирования пути почти всегда.
+    // Нельзя использовать из нескольких потоков одновременно.
+    class Transient {
+    public:
+        Transient() = default;
+
+        Transient(const Transient&) = delete;
+        Transient& operator=(const Transient&) = delete;
+
+        Transient(Transient&& other) noexcept = default;
+        Transient& operator=(Transient&& rhs) noexcept = default;
+
+        size_t Size() const noexcept {
+            return trie_.size;
+        }
+
+        const T& operator[](size_t index) const noexcept {
+            assert(index < Size());
+            return trie_.LeafArray(index)[index & (kBranching - 1)];
+        }
+
+        void PushBack(T value) {
+            trie_.PushBack(std::move(value), edit_);
+        }
+
+        void Set(size_t index, T value) {
+            assert(index < Size());
+            trie_.Set(index, std::move(value), edit_);
+        }
+
+        void PopBack() {
+            assert(Size() > 0);
+            trie_.PopBack(edit_);
+        }
+
+        // Отдаёт накопленное как версию; Transient становится пустым и
+        // больше не меняет узлы отданной версии
+        PersistentVector Persistent() noexcept {
+            edit_ = NextEdit();
+            return PersistentVector(std::move(trie_));
+        }
+
+    private:
+        friend class PersistentVector;
+
+        explicit Transient(const Trie& trie) noexcept
+                : trie_(trie) {
+        }
+
+        Trie trie_;
+        uint64_t edit_ = NextEdit();
+    };
+
+    // Прямой итератор, который спускается по дереву один раз на лист
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() = default;
+
+        reference operator*() const noexcept {
+            return leaf_[index_ & (kBranching - 1)];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        ConstIterator& operator++() noexcept {
+            ++index_;
+            if ((index_ & (kBranching - 1)) == 0 && index_ < trie_->size) {
+                leaf_ = trie_->LeafArray(index_);
+            }
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept {
+            ConstIterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const ConstIterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const ConstIterator& other) const noexcept {
+            return index_ != other.index_;
+        }
+
+    private:
+        friend class PersistentVector;
+
+        ConstIterator(const Trie* trie, size_t index) noexcept
+                : trie_(trie)
+                , leaf_(index < trie->size ? trie->LeafArray(index) : nullptr)
+                , index_(index) {
+        }
+
+        const Trie* trie_ = nullptr;
+        const T* leaf_ = nullptr;
+        size_t index_ = 0;
+    };
+};
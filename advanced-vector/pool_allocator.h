@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+// Пул блоков со степенными классами размеров и потоковыми кешами.
+// Блок помнит кеш, из которого выделен: освобождение в своём потоке кладёт его
+// в локальный список без синхронизации, освобождение в чужом потоке — в lock-free
+// стек владельца, который тот забирает целиком при следующем промахе.
+// Кеши не уничтожаются: при завершении потока кеш сбрасывает свои списки и
+// паркуется до следующего потока, поэтому владелец блока всегда жив.
+class SizeClassPool {
+public:
+    static constexpr size_t kMinClassLog = 5;
+    static constexpr size_t kMaxClassLog = 20;
+    static constexpr size_t kDefaultThreadCacheLimit = size_t{4} << 20;
+
+    static void* Allocate(size_t bytes) {
+        const size_t class_index = ClassIndex(bytes + sizeof(Header));
+        // Кеша нет, только если поток уже разрушает свои thread_local объекты
+        ThreadCache* cache = class_index < kClassCount ? Current() : nullptr;
+        if (cache == nullptr) {
+            Header* header = static_cast<Header*>(operator new(bytes + sizeof(Header)));
+            header->owner = nullptr;
+            header->class_index = kLargeClass;
+            return header + 1;
+        }
+
+        Header* header = cache->Pop(class_index);
+        if (header == nullptr) {
+            header = static_cast<Header*>(operator new(ClassBytes(class_index)));
+            header->class_index = class_index;
+        }
+        header->owner = cache;
+        return header + 1;
+    }
+
+    static void Deallocate(void* p) noexcept {
+        if (p == nullptr) {
+            return;
+        }
+        Header* header = static_cast<Header*>(p) - 1;
+        if (header->class_index == kLargeClass) {
+            operator delete(header);
+            return;
+        }
+        ThreadCache* current = tls_cache_;
+        if (header->owner == current) {
+            current->Push(header);
+        } else {
+            header->owner->PushRemote(header);
+        }
+    }
+
+    // Ограничение на байты, которые кеш текущего потока держит в свободных списках
+    static void SetThreadCacheLimit(size_t bytes) {
+        Current()->limit = bytes;
+    }
+
+    static size_t ThreadCachedBytes() {
+        return Current()->cached_bytes;
+    }
+
+    static constexpr size_t ClassBytes(size_t class_index) noexcept {
+        return size_t{1} << (class_index + kMinClassLog);
+    }
+
+private:
+    static constexpr size_t kClassCount = kMaxClassLog - kMinClassLog + 1;
+    static constexpr size_t kLargeClass = SIZE_MAX;
+
+    struct ThreadCache;
+
+    // Заголовок перед пользовательской памятью сохраняет выравнивание max_align_t
+    struct alignas(std::max_align_t) Header {
+        ThreadCache* owner;
+        size_t class_index;
+    };
+
+    // Свободный блок хранит ссылку на следующий в пользовательской части
+    static Header*& Next(Header* header) noexcept {
+        return *reinterpret_cast<Header**>(header + 1);
+    }
+
+    struct ThreadCache {
+        Header* free_lists[kClassCount] = {};
+        size_t cached_bytes = 0;
+        size_t limit = kDefaultThreadCacheLimit;
+        std::atomic<Header*> remote{nullptr};
+        ThreadCache* next_parked = nullptr;
+
+        Header* Pop(size_t class_index) noexcept {
+            if (free_lists[class_index] == nullptr) {
+                DrainRemote();
+            }
+            Header* header = free_lists[class_index];
+            if (header != nullptr) {
+                free_lists[class_index] = Next(header);
+                cached_bytes -= ClassBytes(class_index);
+            }
+            return header;
+        }
+
+        void Push(Header* header) noexcept {
+            const size_t bytes = ClassBytes(header->class_index);
+            if (cached_bytes + bytes > limit) {
+                operator delete(header);
+                return;
+            }
+            Next(header) = free_lists[header->class_index];
+            free_lists[header->class_index] = header;
+            cached_bytes += bytes;
+        }
+
+        void PushRemote(Header* header) noexcept {
+            Header* head = remote.load(std::memory_order_relaxed);
+            do {
+                Next(header) = head;
+            } while (!remote.compare_exchange_weak(head, header, std::memory_order_release,
+                                                   std::memory_order_relaxed));
+        }
+
+        void DrainRemote() noexcept {
+            Header* header = remote.exchange(nullptr, std::memory_order_acquire);
+            while (header != nullptr) {
+                Header* next = Next(header);
+                Push(header);
+                header = next;
+            }
+        }
+
+        void Flush() noexcept {
+            DrainRemote();
+            for (Header*& list : free_lists) {
+                while (list != nullptr) {
+                    Header* next = Next(list);
+                    operator delete(list);
+                    list = next;
+                }
+            }
+            cached_bytes = 0;
+        }
+    };
+
+    // Привязывает кеш к потоку и паркует его при завершении потока
+    struct CacheBinding {
+        ThreadCache* cache;
+
+        CacheBinding()
+                : cache(Acquire()) {
+            tls_cache_ = cache;
+        }
+
+        ~CacheBinding() {
+            tls_cache_ = nullptr;
+            cache->Flush();
+            cache->limit = kDefaultThreadCacheLimit;
+            std::lock_guard lock(ParkingMutex());
+            cache->next_parked = parked_;
+            parked_ = cache;
+        }
+    };
+
+    static ThreadCache* Current() {
+        if (tls_cache_ == nullptr) {
+            thread_local CacheBinding binding;
+        }
+        return tls_cache_;
+    }
+
+    static ThreadCache* Acquire() {
+        std::lock_guard lock(ParkingMutex());
+        if (parked_ == nullptr) {
+            return new ThreadCache;
+        }
+        ThreadCache* cache = parked_;
+        parked_ = cache->next_parked;
+        return cache;
+    }
+
+    static std::mutex& ParkingMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static size_t ClassIndex(size_t bytes) noexcept {
+        size_t class_index = 0;
+        while (class_index < kClassCount && ClassBytes(class_index) < bytes) {
+            ++class_index;
+        }
+        return class_index;
+    }
+
+    // Список без деструктора: потоки могут завершаться во время разрушения статических объектов
+    static inline ThreadCache* parked_ = nullptr;
+    static inline thread_local ThreadCache* tls_cache_ = nullptr;
+};
+
+// Аллокатор для RawMemory поверх SizeClassPool
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "PoolAllocator supports only default alignment");
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(SizeClassPool::Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        SizeClassPool::Deallocate(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept {
+        return false;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,327 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <iterator>
+
+namespace detail {
+
+// Не меньше 16 элементов и 4 КиБ на блок, с округлением вверх до степени двойки
+template <typename T>
+constexpr size_t DefaultChunkSize() noexcept {
+    const size_t wanted = std::max<size_t>((4096 + sizeof(T) - 1) / sizeof(T), 16);
+    size_t size = 1;
+    while (size < wanted) {
+        size *= 2;
+    }
+    return size;
+}
+
+}  // namespace detail
+
+// Вектор из блоков по ChunkSize элементов, указатели на которые хранит Vector.
+// Элементы никогда не перемещаются: PushBack при нехватке места выделяет один новый
+// блок, поэтому ссылки и указатели на элементы остаются действительными до их удаления,
+// а время вставки не зависит от размера (кроме редкого роста массива указателей на блоки).
+// Годится для больших и неперемещаемых T, например хранящих std::mutex.
+// Итераторы произвольного доступа становятся недействительными при добавлении блока.
+template <typename T, size_t ChunkSize = detail::DefaultChunkSize<T>(), typename Allocator = std::allocator<T>>
+class SegmentedVector {
+    static_assert(ChunkSize != 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+    template <bool kConst>
+    class ChunkIterator;
+
+public:
+    using value_type = T;
+    using allocator_type = typename RawMemory<T, Allocator>::allocator_type;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+    using iterator = ChunkIterator<false>;
+    using const_iterator = ChunkIterator<true>;
+
+    static constexpr size_t kChunkSize = ChunkSize;
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const allocator_type& alloc) noexcept
+            : alloc_(alloc)
+            , chunks_(typename ChunkList::allocator_type(alloc)) {
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+            : SegmentedVector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+        Reserve(other.size_);
+        for (const T& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+            : alloc_(other.alloc_)
+            , chunks_(std::move(other.chunks_))
+            , size_(std::exchange(other.size_, 0)) {
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            SegmentedVector copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            SegmentedVector moved(std::move(rhs));
+            Swap(moved);
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        Clear();
+        for (T* chunk : chunks_) {
+            FreeChunk(chunk);
+        }
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        chunks_.Swap(other.chunks_);
+        std::swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        return iterator(chunks_.begin(), 0);
+    }
+    iterator end() noexcept {
+        return iterator(chunks_.begin(), size_);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(chunks_.begin(), 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(chunks_.begin(), size_);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return chunks_.Size() * kChunkSize;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return chunks_[index / kChunkSize][index % kChunkSize];
+    }
+
+    // Выделяет блоки заранее, чтобы последующие PushBack не обращались к аллокатору
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            chunks_.Reserve((new_capacity + kChunkSize - 1) / kChunkSize);
+            while (Capacity() < new_capacity) {
+                AddChunk();
+            }
+        }
+    }
+
+    void Resize(size_t new_size) {
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+        while (size_ > new_size) {
+            PopBack();
+        }
+    }
+
+    // Освобождает блоки за последним элементом
+    void ShrinkToFit() noexcept {
+        const size_t used = (size_ + kChunkSize - 1) / kChunkSize;
+        while (chunks_.Size() > used) {
+            FreeChunk(chunks_[chunks_.Size() - 1]);
+            chunks_.PopBack();
+        }
+    }
+
+    // Разрушает элементы, сохраняя блоки
+    void Clear() noexcept {
+        while (size_ > 0) {
+            PopBack();
+        }
+    }
+
+    template <typename Obj>
+    void PushBack(Obj&& obj) {
+        EmplaceBack(std::forward<Obj>(obj));
+    }
+
+    // Строгая гарантия исключений; новый блок остаётся в резерве, даже если конструктор бросил
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            AddChunk();
+        }
+        T* slot = &chunks_[size_ / kChunkSize][size_ % kChunkSize];
+        alloc_traits::construct(alloc_, slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        alloc_traits::destroy(alloc_, &(*this)[size_ - 1]);
+        --size_;
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    using ChunkList = Vector<T*, typename alloc_traits::template rebind_alloc<T*>>;
+
+    allocator_type alloc_;
+    ChunkList chunks_;
+    size_t size_ = 0;
+
+    void AddChunk() {
+        RawMemory<T, allocator_type> chunk(kChunkSize, alloc_);
+        chunks_.PushBack(chunk.GetAddress());
+        chunk.Release();
+    }
+
+    void FreeChunk(T* chunk) noexcept {
+        RawMemory<T, allocator_type> memory(alloc_);
+        memory.Adopt(chunk, kChunkSize);
+    }
+
+    template <bool kConst>
+    class ChunkIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<kConst, const T*, T*>;
+        using reference = std::conditional_t<kConst, const T&, T&>;
+
+        ChunkIterator() = default;
+
+        ChunkIterator(T* const* chunks, size_t index) noexcept
+                : chunks_(chunks)
+                , index_(index) {
+        }
+
+        // iterator приводится к const_iterator
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        ChunkIterator(const ChunkIterator<kOtherConst>& other) noexcept
+                : chunks_(other.chunks_)
+                , index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return chunks_[index_ / kChunkSize][index_ % kChunkSize];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        ChunkIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        ChunkIterator operator++(int) noexcept {
+            ChunkIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        ChunkIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        ChunkIterator operator--(int) noexcept {
+            ChunkIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        ChunkIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        ChunkIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend ChunkIterator operator+(ChunkIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend ChunkIterator operator+(difference_type offset, ChunkIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend ChunkIterator operator-(ChunkIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const ChunkIterator& lhs, const ChunkIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const ChunkIterator& lhs, const ChunkIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const ChunkIterator& lhs, const ChunkIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const ChunkIterator& lhs, const ChunkIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator<=(const ChunkIterator& lhs, const ChunkIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>(const ChunkIterator& lhs, const ChunkIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator>=(const ChunkIterator& lhs, const ChunkIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        template <bool>
+        friend class ChunkIterator;
+
+        T* const* chunks_ = nullptr;
+        size_t index_ = 0;
+    };
+};
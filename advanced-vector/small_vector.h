@@ -0,0 +1,105 @@
+#pragma once
+
+#include "vector.h"
+
+// Хранилище для Vector со встроенным буфером на N элементов.
+// Пока ёмкость не превышает N, элементы живут внутри объекта; при росте Vector
+// переносит их в RawMemory обычным путём Reallocate.
+// Перемещение самого хранилища передаёт только буфер в куче: встроенные элементы
+// переносит Vector, которому известен размер.
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallMemory {
+public:
+    static_assert(N > 0, "SmallMemory requires a non-empty inline buffer");
+
+    using allocator_type = typename RawMemory<T, Allocator>::allocator_type;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    static constexpr size_t kInlineCapacity = N;
+
+    SmallMemory() = default;
+
+    explicit SmallMemory(const allocator_type& alloc) noexcept
+            : heap_(alloc) {
+    }
+
+    explicit SmallMemory(size_t capacity, const allocator_type& alloc = allocator_type())
+            : heap_(capacity > N ? RawMemory<T, allocator_type>(capacity, alloc) : RawMemory<T, allocator_type>(alloc)) {
+    }
+
+    SmallMemory(const SmallMemory& other) = delete;
+    SmallMemory& operator=(const SmallMemory& other) = delete;
+
+    SmallMemory(SmallMemory&& other) noexcept = default;
+    SmallMemory& operator=(SmallMemory&& rhs) noexcept = default;
+
+    T* operator+(size_t offset) noexcept {
+        assert(offset <= Capacity());
+        return GetAddress() + offset;
+    }
+
+    const T* operator+(size_t offset) const noexcept {
+        return const_cast<SmallMemory&>(*this) + offset;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallMemory&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Capacity());
+        return GetAddress()[index];
+    }
+
+    // Принимает буфер в куче, в который Vector уже перенёс элементы
+    void Swap(RawMemory<T, allocator_type>& heap) noexcept {
+        heap_.Swap(heap);
+    }
+
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    const T* GetAddress() const noexcept {
+        return const_cast<SmallMemory&>(*this).GetAddress();
+    }
+
+    T* GetAddress() noexcept {
+        return IsInline() ? reinterpret_cast<T*>(inline_) : heap_.GetAddress();
+    }
+
+    size_t Capacity() const {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    void Reallocate(size_t new_capacity) {
+        if (!IsInline()) {
+            heap_.Reallocate(new_capacity);
+            return;
+        }
+        RawMemory<T, allocator_type> heap(new_capacity, heap_.GetAllocator());
+        std::memcpy(static_cast<void*>(heap.GetAddress()), static_cast<const void*>(inline_), sizeof(inline_));
+        heap_.Swap(heap);
+    }
+
+    bool TryExpandInPlace(size_t new_capacity) noexcept {
+        return !IsInline() && heap_.TryExpandInPlace(new_capacity);
+    }
+
+    allocator_type& GetAllocator() noexcept {
+        return heap_.GetAllocator();
+    }
+
+    const allocator_type& GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+private:
+    RawMemory<T, allocator_type> heap_;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+};
+
+// Вектор, хранящий первые N элементов внутри объекта без обращения к аллокатору
+template <typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          typename StatsPolicy = NoStats>
+using SmallVector = Vector<T, Allocator, GrowthPolicy, StatsPolicy, SmallMemory<T, N, Allocator>>;
\ No newline at end of file
@@ -0,0 +1,480 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Вектор записей из полей Fields..., хранящихся по столбцам: каждое поле лежит в своём
+// RawMemory, поэтому цикл по одному полю читает только его байты и векторизуется через Column<I>().
+// Все столбцы имеют одну ёмкость и растут вместе по одному решению DoublingGrowth,
+// в котором размером элемента считается суммарный размер полей.
+// Строка доступна как кортеж ссылок: auto [id, price] = v[i];
+template <typename... Fields>
+class SoaVector {
+    static_assert(sizeof...(Fields) > 0, "SoaVector requires at least one field");
+
+    template <bool kConst>
+    class RowIterator;
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+    using iterator = RowIterator<false>;
+    using const_iterator = RowIterator<true>;
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, value_type>;
+
+    static constexpr size_t kFieldCount = sizeof...(Fields);
+    static constexpr size_t kRowBytes = (sizeof(Fields) + ...);
+
+    SoaVector() = default;
+
+    explicit SoaVector(size_t size)
+            : columns_(RawMemory<Fields>(size)...) {
+        ConstructRows(columns_, 0, size, [](auto& column, size_t i) {
+            ::new (static_cast<void*>(column + i)) std::remove_reference_t<decltype(column[i])>();
+        });
+        size_ = size;
+    }
+
+    SoaVector(const SoaVector& other)
+            : columns_(RawMemory<Fields>(other.size_)...) {
+        ForEachColumnOrUndo([&](auto index) {
+            constexpr size_t I = decltype(index)::value;
+            std::uninitialized_copy_n(other.template Data<I>(), other.size_, Data<I>());
+        }, [&](auto index) {
+            DestroyColumn(std::get<decltype(index)::value>(columns_), 0, other.size_);
+        });
+        size_ = other.size_;
+    }
+
+    SoaVector(SoaVector&& other) noexcept
+            : columns_(std::move(other.columns_))
+            , size_(std::exchange(other.size_, 0)) {
+    }
+
+    SoaVector& operator=(const SoaVector& rhs) {
+        if (this != &rhs) {
+            SoaVector copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    SoaVector& operator=(SoaVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            columns_ = std::move(rhs.columns_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    ~SoaVector() {
+        DestroyRows(columns_, 0, size_);
+    }
+
+    void Swap(SoaVector& other) noexcept {
+        ForEachColumn([&](auto index) {
+            std::get<decltype(index)::value>(columns_).Swap(std::get<decltype(index)::value>(other.columns_));
+        });
+        std::swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row(index, std::index_sequence_for<Fields...>{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return const_cast<SoaVector&>(*this).Row(index, std::index_sequence_for<Fields...>{});
+    }
+
+    // Поле I всех строк подряд; действителен до следующего перевыделения
+    template <size_t I>
+    Span<Field<I>> Column() noexcept {
+        return Span<Field<I>>(Data<I>(), size_);
+    }
+
+    template <size_t I>
+    Span<const Field<I>> Column() const noexcept {
+        return Span<const Field<I>>(Data<I>(), size_);
+    }
+
+    // Строгая гарантия исключений, как у Vector::Reserve: все столбцы выделяются
+    // и заполняются до того, как старые буферы будут освобождены
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Reallocate(new_capacity, 0, [](Columns&, size_t) {});
+        }
+    }
+
+    void ShrinkToFit() {
+        if (size_ < Capacity()) {
+            Reallocate(size_, 0, [](Columns&, size_t) {});
+        }
+    }
+
+    void Clear() noexcept {
+        DestroyRows(columns_, 0, size_);
+        size_ = 0;
+    }
+
+    // Принимает строку целиком: value_type, reference или другой кортеж из kFieldCount значений
+    template <typename RowTuple>
+    void PushBack(RowTuple&& row) {
+        std::apply([this](auto&&... fields) {
+            EmplaceBack(std::forward<decltype(fields)>(fields)...);
+        }, std::forward<RowTuple>(row));
+    }
+
+    // По одному аргументу конструктора на поле. Строгая гарантия исключений:
+    // если бросило поле, уже созданные поля строки разрушаются
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == kFieldCount, "EmplaceBack takes one argument per field");
+        auto fill = [&](Columns& columns, size_t slot) {
+            ConstructRowFrom(columns, slot, std::forward_as_tuple(std::forward<Args>(args)...));
+        };
+        if (size_ == Capacity()) {
+            Reallocate(DoublingGrowth::NextCapacity(Capacity(), size_ + 1, kRowBytes), 1, fill);
+        } else {
+            fill(columns_, size_);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        DestroyRows(columns_, size_ - 1, size_);
+        --size_;
+    }
+
+    iterator Erase(const_iterator pos) {
+        assert(pos >= begin() && pos < end());
+        return Erase(pos, pos + 1);
+    }
+
+    // Сдвигает хвост каждого столбца; если бросило присваивание перемещением,
+    // гарантия базовая, как у Vector::Erase
+    iterator Erase(const_iterator first, const_iterator last) {
+        assert(first >= begin() && first <= last && last <= end());
+        const size_t position = first - begin();
+        const size_t count = last - first;
+        if (count == 0) {
+            return begin() + position;
+        }
+        ForEachColumn([&](auto index) {
+            constexpr size_t I = decltype(index)::value;
+            Field<I>* data = Data<I>();
+            std::move(data + position + count, data + size_, data + position);
+        });
+        DestroyRows(columns_, size_ - count, size_);
+        size_ -= count;
+        return begin() + position;
+    }
+
+private:
+    using Columns = std::tuple<RawMemory<Fields>...>;
+
+    Columns columns_;
+    size_t size_ = 0;
+
+    template <size_t I>
+    Field<I>* Data() noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    template <size_t I>
+    const Field<I>* Data() const noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    template <size_t... I>
+    reference Row(size_t index, std::index_sequence<I...>) noexcept {
+        return reference(std::get<I>(columns_)[index]...);
+    }
+
+    template <typename F>
+    static void ForEachColumn(F&& f) {
+        ForEachColumn(f, std::index_sequence_for<Fields...>{});
+    }
+
+    template <typename F, size_t... I>
+    static void ForEachColumn(F& f, std::index_sequence<I...>) {
+        (f(std::integral_constant<size_t, I>{}), ...);
+    }
+
+    // Вызывает op(index) для столбцов подряд; если столбец бросил, вызывает undo(index)
+    // для уже обработанных столбцов и пробрасывает исключение
+    template <typename Op, typename Undo>
+    static void ForEachColumnOrUndo(Op&& op, Undo&& undo) {
+        size_t done = 0;
+        try {
+            ForEachColumn([&](auto index) {
+                op(index);
+                ++done;
+            });
+        } catch (...) {
+            ForEachColumn([&](auto index) {
+                if (decltype(index)::value < done) {
+                    undo(index);
+                }
+            });
+            throw;
+        }
+    }
+
+    // Создаёт строки [first, first + count) вызовами make(column, row) в каждом столбце
+    template <typename Make>
+    static void ConstructRows(Columns& columns, size_t first, size_t count, const Make& make) {
+        ForEachColumnOrUndo([&](auto index) {
+            auto& column = std::get<decltype(index)::value>(columns);
+            size_t i = first;
+            try {
+                for (; i < first + count; ++i) {
+                    make(column, i);
+                }
+            } catch (...) {
+                DestroyColumn(column, first, i);
+                throw;
+            }
+        }, [&](auto index) {
+            DestroyColumn(std::get<decltype(index)::value>(columns), first, first + count);
+        });
+    }
+
+    // Создаёт строку slot, передавая конструктору поля I элемент I кортежа args
+    template <typename ArgsTuple>
+    static void ConstructRowFrom(Columns& columns, size_t slot, ArgsTuple&& args) {
+        ForEachColumnOrUndo([&](auto index) {
+            constexpr size_t I = decltype(index)::value;
+            ::new (static_cast<void*>(std::get<I>(columns) + slot))
+                    Field<I>(std::forward<std::tuple_element_t<I, std::decay_t<ArgsTuple>>>(std::get<I>(args)));
+        }, [&](auto index) {
+            DestroyColumn(std::get<decltype(index)::value>(columns), slot, slot + 1);
+        });
+    }
+
+    template <typename T>
+    static void DestroyColumn(RawMemory<T>& column, size_t first, size_t last) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::destroy(column + first, column + last);
+        }
+    }
+
+    static void DestroyRows(Columns& columns, size_t first, size_t last) noexcept {
+        ForEachColumn([&](auto index) {
+            DestroyColumn(std::get<decltype(index)::value>(columns), first, last);
+        });
+    }
+
+    template <typename T>
+    static constexpr bool kRelocatesNothrow = is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+    // Если перенос хоть одного столбца может бросить, перемещать нельзя ни один: исключение
+    // в следующем столбце оставило бы уже перемещённые оригиналы пустыми
+    static constexpr bool kMoveColumns = (kRelocatesNothrow<Fields> && ...);
+
+    // Перенос столбца в новый буфер по тем же правилам, что Vector::RelocateN
+    template <typename T>
+    static void RelocateColumn(RawMemory<T>& from, size_t n, RawMemory<T>& to) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(to.GetAddress()), static_cast<const void*>(from.GetAddress()),
+                            n * sizeof(T));
+            }
+        } else if constexpr ((kMoveColumns && std::is_nothrow_move_constructible_v<T>)
+                             || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from.GetAddress(), n, to.GetAddress());
+        } else {
+            std::uninitialized_copy_n(from.GetAddress(), n, to.GetAddress());
+        }
+    }
+
+    template <typename T>
+    static void DestroyRelocatedColumn(RawMemory<T>& column, size_t n) noexcept {
+        if constexpr (!is_trivially_relocatable_v<T>) {
+            DestroyColumn(column, 0, n);
+        }
+    }
+
+    // Выделяет все столбцы ёмкостью new_capacity, вызывает fill(new_columns, size_) для
+    // gap новых строк в конце и переносит старые строки. Строгая гарантия исключений.
+    template <typename Fill>
+    void Reallocate(size_t new_capacity, size_t gap, Fill&& fill) {
+        assert(size_ + gap <= new_capacity);
+        Columns new_columns{RawMemory<Fields>(new_capacity)...};
+        fill(new_columns, size_);
+        try {
+            // Оригиналы остаются на месте до конца переноса: побайтово перенесённые и
+            // скопированные столбцы не тронуты, а перемещаются они, только когда ничто не бросает
+            ForEachColumnOrUndo([&](auto index) {
+                constexpr size_t I = decltype(index)::value;
+                RelocateColumn(std::get<I>(columns_), size_, std::get<I>(new_columns));
+            }, [&](auto index) {
+                DestroyRelocatedColumn(std::get<decltype(index)::value>(new_columns), size_);
+            });
+        } catch (...) {
+            DestroyRows(new_columns, size_, size_ + gap);
+            throw;
+        }
+        ForEachColumn([&](auto index) {
+            constexpr size_t I = decltype(index)::value;
+            DestroyRelocatedColumn(std::get<I>(columns_), size_);
+            std::get<I>(columns_).Swap(std::get<I>(new_columns));
+        });
+    }
+
+    template <bool kConst>
+    class RowIterator {
+        using Owner = std::conditional_t<kConst, const SoaVector, SoaVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = SoaVector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<kConst, SoaVector::const_reference, SoaVector::reference>;
+        using pointer = void;
+
+        RowIterator() = default;
+
+        RowIterator(Owner* owner, size_t index) noexcept
+                : owner_(owner)
+                , index_(index) {
+        }
+
+        // iterator приводится к const_iterator
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        RowIterator(const RowIterator<kOtherConst>& other) noexcept
+                : owner_(other.owner_)
+                , index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        size_t Index() const noexcept {
+            return index_;
+        }
+
+        RowIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        RowIterator operator++(int) noexcept {
+            RowIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        RowIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        RowIterator operator--(int) noexcept {
+            RowIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        RowIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        RowIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend RowIterator operator+(RowIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend RowIterator operator+(difference_type offset, RowIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend RowIterator operator-(RowIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator<=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator>=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        template <bool>
+        friend class RowIterator;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+};
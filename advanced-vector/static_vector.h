@@ -0,0 +1,508 @@
+#pragma once
+
+#include "vector.h"
+
+#include <stdexcept>
+
+namespace detail {
+
+// Аллокатор StaticVector: любая попытка выделить память означает переполнение
+template <typename T>
+struct NoHeapAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    NoHeapAllocator() = default;
+
+    template <typename U>
+    NoHeapAllocator(const NoHeapAllocator<U>&) noexcept {
+    }
+
+    [[noreturn]] T* allocate(size_t) {
+        throw std::length_error("StaticVector capacity exceeded");
+    }
+
+    void deallocate(T*, size_t) noexcept {
+    }
+
+    template <typename U>
+    bool operator==(const NoHeapAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const NoHeapAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+}  // namespace detail
+
+// Хранилище для Vector ровно на N элементов внутри объекта, без кучи.
+// Рост за N доходит до NoHeapAllocator::allocate и бросает std::length_error
+// до каких-либо изменений, поэтому гарантии исключений Vector сохраняются.
+template <typename T, size_t N>
+class FixedMemory {
+public:
+    static_assert(N > 0, "FixedMemory requires a non-empty buffer");
+
+    using allocator_type = detail::NoHeapAllocator<T>;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    static constexpr size_t kInlineCapacity = N;
+
+    FixedMemory() = default;
+
+    explicit FixedMemory(const allocator_type&) noexcept {
+    }
+
+    explicit FixedMemory(size_t capacity, const allocator_type& = allocator_type()) {
+        if (capacity > N) {
+            alloc_.allocate(capacity);
+        }
+    }
+
+    FixedMemory(const FixedMemory& other) = delete;
+    FixedMemory& operator=(const FixedMemory& other) = delete;
+
+    // Элементы переносит Vector, буферу переносить нечего
+    FixedMemory(FixedMemory&&) noexcept {
+    }
+
+    FixedMemory& operator=(FixedMemory&&) noexcept {
+        return *this;
+    }
+
+    T* operator+(size_t offset) noexcept {
+        assert(offset <= N);
+        return GetAddress() + offset;
+    }
+
+    const T* operator+(size_t offset) const noexcept {
+        return const_cast<FixedMemory&>(*this) + offset;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<FixedMemory&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < N);
+        return GetAddress()[index];
+    }
+
+    // Vector обменивается с буфером в куче только при переходе во встроенный буфер,
+    // а буферов в куче у FixedMemory не бывает
+    void Swap(RawMemory<T, allocator_type>& heap) noexcept {
+        assert(heap.GetAddress() == nullptr);
+        (void)heap;
+    }
+
+    bool IsInline() const noexcept {
+        return true;
+    }
+
+    const T* GetAddress() const noexcept {
+        return const_cast<FixedMemory&>(*this).GetAddress();
+    }
+
+    T* GetAddress() noexcept {
+        return reinterpret_cast<T*>(buffer_);
+    }
+
+    size_t Capacity() const {
+        return N;
+    }
+
+    allocator_type& GetAllocator() noexcept {
+        return alloc_;
+    }
+
+    const allocator_type& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    [[no_unique_address]] allocator_type alloc_;
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+};
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool kConstexprStatic = std::is_trivial_v<T>;
+
+}  // namespace detail
+
+// Вектор не больше чем на N элементов, никогда не обращающийся к куче.
+// Интерфейс Vector плюс TryPushBack/TryEmplaceBack, которые при заполнении
+// возвращают false/nullptr; PushBack и Emplace сверх N бросают std::length_error.
+// Для тривиальных T (int, POD-структуры) вектор constexpr и годится для таблиц,
+// построенных при компиляции; агрегаты можно заполнять через EmplaceBack(поле, поле, ...).
+// С C++20 буфер за Size() во время выполнения не инициализируется; до C++20 constexpr-
+// конструктор обязан инициализировать все члены, поэтому конструктор обнуляет все N элементов.
+// Открытый интерфейс и поведение те же, что у Vector с FixedMemory, в котором хранятся
+// остальные T (кроме Release/Adopt, недоступных и там), поэтому обобщённый код не зависит
+// от выбранной специализации. Общих вспомогательных функций с Vector у неё нет: Vector
+// работает с неинициализированной памятью через аллокатор и memmove, что недопустимо
+// в constexpr, а здесь элементы всегда живы и сдвигаются присваиванием. Совпадение
+// поведения проверяется тестом, выполняющим одни и те же операции над обоими.
+template <typename T, size_t N, bool = detail::kConstexprStatic<T>>
+class StaticVector;
+
+template <typename T, size_t N>
+class StaticVector<T, N, false> : public Vector<T, detail::NoHeapAllocator<T>, DoublingGrowth, NoStats,
+                                                FixedMemory<T, N>> {
+    using Base = Vector<T, detail::NoHeapAllocator<T>, DoublingGrowth, NoStats, FixedMemory<T, N>>;
+
+public:
+    static constexpr size_t kCapacity = N;
+
+    using Base::Base;
+
+    StaticVector() = default;
+
+    template <typename Obj>
+    bool TryPushBack(Obj&& obj) {
+        return TryEmplaceBack(std::forward<Obj>(obj)) != nullptr;
+    }
+
+    template <typename... Args>
+    T* TryEmplaceBack(Args&&... args) {
+        if (this->Size() == N) {
+            return nullptr;
+        }
+        return &this->EmplaceBack(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T, size_t N>
+class StaticVector<T, N, true> {
+public:
+    static_assert(N > 0, "StaticVector requires a non-zero capacity");
+
+    using value_type = T;
+    using allocator_type = detail::NoHeapAllocator<T>;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t kCapacity = N;
+    static constexpr bool kDefaultInitIsNoop = true;
+
+    constexpr StaticVector() noexcept {
+        StartLifetime(0);
+    }
+
+    // Элементы инициализируются значением, как в Vector(size)
+    constexpr explicit StaticVector(size_t size)
+            : size_(CheckCapacity(size)) {
+        StartLifetime(size);
+    }
+
+    constexpr StaticVector(size_t size, default_init_t)
+            : size_(CheckCapacity(size)) {
+        StartLifetime(0);
+    }
+
+    // Поток выделять незачем: буфер внутри объекта
+    constexpr StaticVector(size_t size, parallel_t)
+            : StaticVector(size) {
+    }
+
+    // Копируются только элементы, а не весь буфер
+    constexpr StaticVector(const StaticVector& other) noexcept
+            : size_(other.size_) {
+        StartLifetime(0);
+        for (size_t i = 0; i < size_; ++i) {
+            data_[i] = other.data_[i];
+        }
+    }
+
+    constexpr StaticVector(const StaticVector& other, parallel_t)
+            : StaticVector(other) {
+    }
+
+    constexpr StaticVector& operator=(const StaticVector& rhs) noexcept {
+        for (size_t i = 0; i < rhs.size_; ++i) {
+            data_[i] = rhs.data_[i];
+        }
+        size_ = rhs.size_;
+        return *this;
+    }
+
+    constexpr iterator begin() noexcept {
+        return data_;
+    }
+    constexpr iterator end() noexcept {
+        return data_ + size_;
+    }
+    constexpr const_iterator begin() const noexcept {
+        return data_;
+    }
+    constexpr const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+    constexpr const_iterator cbegin() const noexcept {
+        return data_;
+    }
+    constexpr const_iterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+    constexpr T* Data() noexcept {
+        return data_;
+    }
+
+    constexpr const T* Data() const noexcept {
+        return data_;
+    }
+
+    constexpr allocator_type GetAllocator() const noexcept {
+        return allocator_type();
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    constexpr size_t Capacity() const noexcept {
+        return N;
+    }
+
+    constexpr void Swap(StaticVector& other) noexcept {
+        const size_t common = std::min(size_, other.size_);
+        for (size_t i = 0; i < common; ++i) {
+            const T value = data_[i];
+            data_[i] = other.data_[i];
+            other.data_[i] = value;
+        }
+        // Хвост длинного переносится в короткий, не читая неинициализированных элементов
+        StaticVector& longer = size_ > other.size_ ? *this : other;
+        StaticVector& shorter = size_ > other.size_ ? other : *this;
+        for (size_t i = common; i < longer.size_; ++i) {
+            shorter.data_[i] = longer.data_[i];
+        }
+        const size_t size = size_;
+        size_ = other.size_;
+        other.size_ = size;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    constexpr void Reserve(size_t new_capacity) {
+        CheckCapacity(new_capacity);
+    }
+
+    constexpr void Resize(size_t new_size) {
+        CheckCapacity(new_size);
+        for (size_t i = size_; i < new_size; ++i) {
+            data_[i] = T();
+        }
+        size_ = new_size;
+    }
+
+    constexpr void Resize(size_t new_size, parallel_t) {
+        Resize(new_size);
+    }
+
+    // Ёмкость встроенного буфера не меняется
+    constexpr void ShrinkToFit() noexcept {
+    }
+
+    constexpr void Clear() noexcept {
+        size_ = 0;
+    }
+
+    constexpr void ClearAndRelease() noexcept {
+        Clear();
+    }
+
+    // Новые элементы не инициализируются, как в Vector
+    constexpr void ResizeDefaultInit(size_t new_size) {
+        size_ = CheckCapacity(new_size);
+    }
+
+    Span<T> AppendUninitialized(size_t n) {
+        ResizeDefaultInit(size_ + n);
+        return Span<T>(data_ + size_ - n, n);
+    }
+
+    constexpr void AppendDefault(size_t n) {
+        Resize(size_ + n);
+    }
+
+    template <typename InputIt>
+    constexpr void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
+    template <typename Obj>
+    constexpr void PushBack(Obj&& obj) {
+        EmplaceBack(std::forward<Obj>(obj));
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        return *Emplace(end(), std::forward<Args>(args)...);
+    }
+
+    // Перевыделений нет, поэтому место вызова не нужно
+    template <typename... Args>
+    constexpr T& EmplaceBackAt(CallSite, Args&&... args) {
+        return EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    template <typename Obj>
+    constexpr bool TryPushBack(Obj&& obj) {
+        return TryEmplaceBack(std::forward<Obj>(obj)) != nullptr;
+    }
+
+    template <typename... Args>
+    constexpr T* TryEmplaceBack(Args&&... args) {
+        if (size_ == N) {
+            return nullptr;
+        }
+        data_[size_] = MakeValue(std::forward<Args>(args)...);
+        return &data_[size_++];
+    }
+
+    constexpr void PopBack() noexcept {
+        if (size_ > 0) {
+            --size_;
+        }
+    }
+
+    // Значение строится до сдвига, поэтому аргументы могут ссылаться на элементы
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        const size_t position = pos - begin();
+        CheckCapacity(size_ + 1);
+        const T value = MakeValue(std::forward<Args>(args)...);
+        for (size_t i = size_; i > position; --i) {
+            data_[i] = data_[i - 1];
+        }
+        data_[position] = value;
+        ++size_;
+        return data_ + position;
+    }
+
+    template <typename... Args>
+    constexpr iterator EmplaceAt(CallSite, const_iterator pos, Args&&... args) {
+        return Emplace(pos, std::forward<Args>(args)...);
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    constexpr iterator Insert(const_iterator pos, size_t count, const T& value) {
+        assert(pos >= begin() && pos <= end());
+        const size_t position = pos - begin();
+        CheckCapacity(size_ + count);
+        const T copy = value;
+        OpenGap(position, count);
+        for (size_t i = 0; i < count; ++i) {
+            data_[position + i] = copy;
+        }
+        return data_ + position;
+    }
+
+    // Итераторы не должны указывать на элементы *this
+    template <typename InputIt,
+              typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+                      typename std::iterator_traits<InputIt>::iterator_category>>>
+    constexpr iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        assert(pos >= begin() && pos <= end());
+        const size_t position = pos - begin();
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            CheckCapacity(size_ + count);
+            OpenGap(position, count);
+            for (size_t i = position; first != last; ++first, ++i) {
+                data_[i] = *first;
+            }
+        } else {
+            // Однопроходный диапазон: дописываем в конец и поворачиваем на место, как Vector;
+            // при переполнении дописанное остаётся в конце
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(data_ + position, data_ + old_size, data_ + size_);
+        }
+        return data_ + position;
+    }
+
+    constexpr iterator Erase(const_iterator pos) {
+        assert(pos >= begin() && pos < end());
+        return Erase(pos, pos + 1);
+    }
+
+    constexpr iterator Erase(const_iterator first, const_iterator last) {
+        assert(first >= begin() && first <= last && last <= end());
+        const size_t position = first - begin();
+        const size_t count = last - first;
+        for (size_t i = position; i + count < size_; ++i) {
+            data_[i] = data_[i + count];
+        }
+        size_ -= count;
+        return data_ + position;
+    }
+
+private:
+#ifdef __cpp_lib_is_constant_evaluated
+    T data_[N];
+#else
+    T data_[N] = {};
+#endif
+    size_t size_ = 0;
+
+    // Инициализирует значением первые count элементов (до C++20 буфер уже обнулён).
+    // При вычислении на этапе компиляции читать неинициализированное нельзя, поэтому
+    // там инициализируется весь буфер
+    constexpr void StartLifetime([[maybe_unused]] size_t count) noexcept {
+#ifdef __cpp_lib_is_constant_evaluated
+        if (std::is_constant_evaluated()) {
+            count = N;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            data_[i] = T();
+        }
+#endif
+    }
+
+    // Сдвигает [position, size_) на count вправо; ёмкость проверена вызывающим
+    constexpr void OpenGap(size_t position, size_t count) noexcept {
+        for (size_t i = size_; i > position; --i) {
+            data_[i - 1 + count] = data_[i - 1];
+        }
+        size_ += count;
+    }
+
+    // Агрегаты, не имеющие конструктора от args, инициализируются списком
+    template <typename... Args>
+    static constexpr T MakeValue(Args&&... args) {
+        if constexpr (std::is_constructible_v<T, Args&&...>) {
+            return T(std::forward<Args>(args)...);
+        } else {
+            return T{std::forward<Args>(args)...};
+        }
+    }
+
+    static constexpr size_t CheckCapacity(size_t size) {
+        if (size > N) {
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+        return size;
+    }
+};
@@ -1,19 +1,306 @@
 #pragma once
 
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <new>
 #include <utility>
 #include <memory>
+#include <functional>
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <exception>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#ifdef __cpp_lib_source_location
+#include <source_location>
+#endif
+
+// С -DVECTOR_USDT_PROBES каждое перевыделение любого Vector отмечается статической
+// точкой трассировки advanced_vector:reallocate (нужен <sys/sdt.h> из systemtap-sdt-dev).
+// Аргументы: размер элемента, старая и новая ёмкость, перенесённые байты, время в нс,
+// файл и строка места вызова. Пока к точке никто не подключён, она стоит одну инструкцию nop:
+//   bpftrace -e 'usdt:./app:advanced_vector:reallocate { @us[str(arg5), arg6] = hist(arg4 / 1000); }'
+#ifdef VECTOR_USDT_PROBES
+#include <sys/sdt.h>
+#endif
+
+// Тип, объект которого можно перенести в другую память побайтовым копированием
+// без вызова деструктора у источника. Пользовательские типы подключаются специализацией.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// Тег конструирования без инициализации элементов
+struct default_init_t {
+    explicit default_init_t() = default;
+};
+
+inline constexpr default_init_t default_init{};
+
+// Тег параллельного создания элементов: диапазон делится на части по страницам, и каждую
+// часть создаёт свой поток, поэтому её страницы размещаются на узле NUMA этого потока.
+// threads = 0 — по числу аппаратных потоков; короткие диапазоны создаются в вызывающем потоке.
+struct parallel_t {
+    size_t threads = 0;
+};
+
+inline constexpr parallel_t parallel{};
+
+// Невладеющее представление непрерывного диапазона элементов
+template <typename T>
+class Span {
+public:
+    Span() = default;
+
+    Span(T* data, size_t size) noexcept
+            : data_(data)
+            , size_(size) {
+    }
+
+    T* begin() const noexcept {
+        return data_;
+    }
+
+    T* end() const noexcept {
+        return data_ + size_;
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+namespace detail {
+
+template <typename Alloc, typename T, typename = void>
+struct HasConstructMember : std::false_type {};
+
+template <typename Alloc, typename T>
+struct HasConstructMember<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().construct(
+        std::declval<T*>(), std::declval<T&&>()))>> : std::true_type {};
+
+template <typename Alloc, typename T, typename = void>
+struct HasDestroyMember : std::false_type {};
+
+template <typename Alloc, typename T>
+struct HasDestroyMember<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().destroy(
+        std::declval<T*>()))>> : std::true_type {};
+
+template <typename Alloc, typename T, typename = void>
+struct HasReallocateMember : std::false_type {};
+
+template <typename Alloc, typename T>
+struct HasReallocateMember<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+        std::declval<T*>(), size_t{}, size_t{}))>> : std::true_type {};
+
+// Прямой итератор, count раз возвращающий одно и то же значение
 template <typename T>
+class RepeatIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    RepeatIterator() = default;
+
+    RepeatIterator(const T& value, size_t index) noexcept
+            : value_(&value)
+            , index_(index) {
+    }
+
+    reference operator*() const noexcept {
+        return *value_;
+    }
+
+    pointer operator->() const noexcept {
+        return value_;
+    }
+
+    RepeatIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    RepeatIterator operator++(int) noexcept {
+        RepeatIterator old = *this;
+        ++index_;
+        return old;
+    }
+
+    bool operator==(const RepeatIterator& other) const noexcept {
+        return index_ == other.index_;
+    }
+
+    bool operator!=(const RepeatIterator& other) const noexcept {
+        return index_ != other.index_;
+    }
+
+private:
+    const T* value_ = nullptr;
+    size_t index_ = 0;
+};
+
+template <typename Alloc, typename T, typename = void>
+struct HasExpandInPlaceMember : std::false_type {};
+
+template <typename Alloc, typename T>
+struct HasExpandInPlaceMember<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().expand_in_place(
+        std::declval<T*>(), size_t{}, size_t{}))>> : std::true_type {};
+
+template <typename Policy, typename = void>
+struct HasShrinkCapacity : std::false_type {};
+
+template <typename Policy>
+struct HasShrinkCapacity<Policy, std::void_t<decltype(Policy::ShrinkCapacity(size_t{}, size_t{}, size_t{}))>>
+        : std::true_type {};
+
+// Размер части параллельного создания в элементах; n — если делить не стоит
+inline size_t ParallelChunkSize(size_t n, size_t element_size, size_t threads) noexcept {
+    constexpr size_t kPageBytes = 4096;
+    constexpr size_t kMinChunkBytes = size_t{1} << 20;
+    if (threads == 0) {
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    const size_t page = std::max<size_t>(kPageBytes / element_size, 1);
+    const size_t min_chunk = std::max<size_t>(kMinChunkBytes / element_size, page);
+    const size_t chunks = std::min(threads, n / min_chunk);
+    if (chunks <= 1) {
+        return n;
+    }
+    const size_t chunk = (n + chunks - 1) / chunks;
+    return (chunk + page - 1) / page * page;
+}
+
+// Выполняет body(index) для index из [0, count): нулевую часть — в вызывающем потоке,
+// остальные — в отдельных потоках (или тоже в вызывающем, если поток не создать).
+// Первое исключение из body сохраняется в error.
+template <typename Body>
+void ParallelFor(size_t count, const Body& body, std::exception_ptr& error) {
+    std::mutex mutex;
+    auto run = [&](size_t index) noexcept {
+        try {
+            body(index);
+        } catch (...) {
+            std::lock_guard lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(count - 1);
+    size_t spawned = 1;
+    for (; spawned < count; ++spawned) {
+        try {
+            workers.emplace_back(run, spawned);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    run(0);
+    for (size_t index = spawned; index < count; ++index) {
+        run(index);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// construct/destroy аллокатора сводятся к placement new и вызову деструктора
+// (std::allocator до C++20 объявляет эти члены, но их поведение стандартное)
+template <typename Alloc, typename T>
+inline constexpr bool kUsesDefaultConstruct = std::is_same_v<Alloc, std::allocator<T>>
+                                              || (!HasConstructMember<Alloc, T>::value
+                                                  && !HasDestroyMember<Alloc, T>::value);
+
+// Поколение буфера Vector для проверяемых итераторов; без них — пустой тип без состояния
+template <bool kEnabled>
+struct BufferGeneration {
+    void Bump() noexcept {
+    }
+};
+
+template <>
+struct BufferGeneration<true> {
+    uint64_t value = 0;
+
+    void Bump() noexcept {
+        ++value;
+    }
+};
+
+#ifdef VECTOR_USDT_PROBES
+inline constexpr bool kUsdtProbes = true;
+#else
+inline constexpr bool kUsdtProbes = false;
+#endif
+
+// Секундомер перевыделения; без наблюдателей не читает часы
+template <bool kEnabled>
+struct ReallocationTimer {
+    uint64_t ElapsedNs() const noexcept {
+        return 0;
+    }
+};
+
+template <>
+struct ReallocationTimer<true> {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    uint64_t ElapsedNs() const noexcept {
+        return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+};
+
+}  // namespace detail
+
+template <typename T, typename Allocator = std::allocator<T>>
 class RawMemory {
 public:
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    static constexpr size_t kInlineCapacity = 0;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-            : buffer_(Allocate(capacity))
+    explicit RawMemory(const allocator_type& alloc) noexcept
+            : alloc_(alloc) {
+    }
+
+    explicit RawMemory(size_t capacity, const allocator_type& alloc = allocator_type())
+            : alloc_(alloc)
+            , buffer_(Allocate(capacity))
             , capacity_(capacity) {
     }
 
@@ -21,13 +308,19 @@ public:
     RawMemory& operator=(const RawMemory& other) = delete;
 
     RawMemory(RawMemory&& other) noexcept :
+            alloc_(std::move(other.alloc_)),
             buffer_(std::exchange(other.buffer_, nullptr)),
             capacity_(std::exchange(other.capacity_, 0))
     {}
 
+    // Перемещающее присваивание всегда забирает аллокатор rhs:
+    // решение о распространении аллокатора принимает владелец (Vector)
     RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
-            this->Swap(rhs);
+            Deallocate(buffer_);
+            alloc_ = std::move(rhs.alloc_);
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
         }
 
         return *this;
@@ -55,6 +348,7 @@ public:
         return buffer_[index];
     }
 
+    // Обменивает только буферы; аллокаторы обмениваются владельцем явно
     void Swap(RawMemory& other) noexcept {
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
@@ -72,68 +366,430 @@ public:
         return capacity_;
     }
 
+    // Меняет ёмкость через allocator.reallocate(p, old_n, new_n), который сохраняет
+    // побайтовую копию содержимого и может расширить буфер на месте.
+    // Пригодно только для побайтово переносимых T; при исключении буфер не меняется.
+    void Reallocate(size_t new_capacity) {
+        static_assert(detail::HasReallocateMember<allocator_type, T>::value);
+        if (buffer_ == nullptr) {
+            buffer_ = Allocate(new_capacity);
+        } else if (new_capacity == 0) {
+            Deallocate(buffer_);
+            buffer_ = nullptr;
+        } else {
+            buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+        }
+        capacity_ = new_capacity;
+    }
+
+    // Удлиняет буфер без перемещения через allocator.expand_in_place(p, old_n, new_n),
+    // если аллокатор это умеет; годится для любых T, так как элементы остаются на месте
+    bool TryExpandInPlace(size_t new_capacity) noexcept {
+        if constexpr (detail::HasExpandInPlaceMember<allocator_type, T>::value) {
+            if (buffer_ != nullptr && alloc_.expand_in_place(buffer_, capacity_, new_capacity)) {
+                capacity_ = new_capacity;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Отдаёт буфер вызывающему; вернуть его нужно аллокатору, равному GetAllocator()
+    T* Release() noexcept {
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
+    // Принимает буфер на capacity элементов, выделенный аллокатором, равным GetAllocator()
+    void Adopt(T* buffer, size_t capacity) noexcept {
+        Deallocate(buffer_);
+        buffer_ = buffer;
+        capacity_ = capacity;
+    }
+
+    allocator_type& GetAllocator() noexcept {
+        return alloc_;
+    }
+
+    const allocator_type& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
 private:
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    T* Allocate(size_t n) {
+        return n != 0 ? alloc_traits::allocate(alloc_, n) : nullptr;
     }
 
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    void Deallocate(T* buf) noexcept {
+        if (buf != nullptr) {
+            alloc_traits::deallocate(alloc_, buf, capacity_);
+        }
     }
 
+    allocator_type alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
-template <typename T>
+// Политики роста: NextCapacity(capacity, required, element_size) возвращает новую
+// ёмкость не меньше required при переполнении буфера ёмкостью capacity.
+// Ею пользуются все пути роста Vector; Reserve выделяет ровно запрошенное.
+struct DoublingGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t) noexcept {
+        return std::max(capacity == 0 ? size_t{1} : capacity * 2, required);
+    }
+};
+
+// Рост в Num/Den раз; при коэффициенте меньше золотого сечения освобождённые
+// ранее блоки в сумме успевают вместить следующий буфер и переиспользуются аллокатором
+template <size_t Num, size_t Den>
+struct FactorGrowth {
+    static_assert(Num > Den, "Growth factor must be greater than 1");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t) noexcept {
+        const size_t increment = capacity / Den * (Num - Den) + capacity % Den * (Num - Den) / Den;
+        return std::max(capacity + std::max(increment, size_t{1}), required);
+    }
+};
+
+using OneAndHalfGrowth = FactorGrowth<3, 2>;
+using GoldenRatioGrowth = FactorGrowth<1618, 1000>;
+
+// Округляет ёмкость Base вверх до класса размеров jemalloc (8, затем шаг 16 до 128 байт,
+// дальше четыре класса на каждое удвоение), чтобы использовать резерв, который аллокатор отдаёт всё равно
+template <typename Base = DoublingGrowth>
+struct SizeClassGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t bytes = RoundToSizeClass(Base::NextCapacity(capacity, required, element_size) * element_size);
+        return std::max(bytes / element_size, required);
+    }
+
+    static constexpr size_t RoundToSizeClass(size_t bytes) noexcept {
+        if (bytes <= 8) {
+            return 8;
+        }
+        if (bytes <= 128) {
+            return (bytes + 15) / 16 * 16;
+        }
+        size_t group = 64;
+        while (group * 2 < bytes) {
+            group *= 2;
+        }
+        const size_t step = group / 4;
+        return (bytes + step - 1) / step * step;
+    }
+};
+
+// После StepBytes байт растёт фиксированными шагами по StepBytes вместо Base, чтобы
+// резерв огромных буферов оставался ограниченным
+template <size_t StepBytes = (size_t{64} << 20), typename Base = DoublingGrowth>
+struct FixedStepGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        if (capacity * element_size < StepBytes) {
+            return Base::NextCapacity(capacity, required, element_size);
+        }
+        return std::max(capacity + std::max(StepBytes / element_size, size_t{1}), required);
+    }
+};
+
+// Добавляет к Base автоматическое сжатие: когда размер падает ниже Num/Den ёмкости,
+// буфер уменьшается до двойного размера. После сжатия вектор заполнен наполовину,
+// поэтому чередование PushBack/PopBack у границы не вызывает перевыделений.
+// Буферы не больше MinCapacity не сжимаются.
+template <typename Base = DoublingGrowth, size_t Num = 1, size_t Den = 4, size_t MinCapacity = 16>
+struct AutoShrinkGrowth : Base {
+    static_assert(Num * 2 < Den, "Shrink threshold must be below half of capacity for hysteresis");
+
+    static constexpr size_t ShrinkCapacity(size_t capacity, size_t size, size_t) noexcept {
+        if (capacity <= MinCapacity || size * Den >= capacity * Num) {
+            return capacity;
+        }
+        return std::max(size * 2, MinCapacity);
+    }
+};
+
+// Место вызова операции Vector, вызвавшей перевыделение; file == nullptr — неизвестно
+struct CallSite {
+    const char* file = nullptr;
+    const char* function = nullptr;
+    unsigned line = 0;
+
+    // Как аргумент по умолчанию возвращает место вызова функции, а не её объявления
+#ifdef __cpp_lib_source_location
+    static constexpr CallSite Current(std::source_location location = std::source_location::current()) noexcept {
+        return CallSite{location.file_name(), location.function_name(), static_cast<unsigned>(location.line())};
+    }
+#else
+    static constexpr CallSite Current(const char* file = __builtin_FILE(), const char* function = __builtin_FUNCTION(),
+                                      unsigned line = __builtin_LINE()) noexcept {
+        return CallSite{file, function, line};
+    }
+#endif
+};
+
+// Сведения о перевыделении буфера Vector для политик статистики
+struct ReallocationEvent {
+    size_t element_size = 0;
+    size_t old_capacity = 0;
+    size_t new_capacity = 0;
+    // Число элементов, которым нужно было место (размер после операции)
+    size_t required = 0;
+    size_t elements_moved = 0;
+    size_t elements_copied = 0;
+    size_t elements_relocated_bitwise = 0;
+    // Байты перенесённых элементов; realloc считается переносом всех, удлинение на месте — ни одного
+    size_t bytes_moved = 0;
+    // Время от начала перевыделения до освобождения старого буфера
+    uint64_t elapsed_ns = 0;
+    // Буфер изменён через allocator.reallocate, без выделения нового
+    bool in_place = false;
+    // Известно для Reserve, Resize, PushBack, Insert, Append, ShrinkToFit, EmplaceBackAt и
+    // EmplaceAt; у EmplaceBack и Emplace пусто: после пакета аргументов не поставить умолчание
+    CallSite call_site;
+};
+
+// Политика статистики по умолчанию: хуки пусты и исчезают при компиляции.
+// Включаемая политика — VectorStats из vector_stats.h.
+struct NoStats {
+    static constexpr bool kEnabled = false;
+
+    static void OnAllocate(size_t, size_t) noexcept {
+    }
+
+    static void OnReallocate(const ReallocationEvent&) noexcept {
+    }
+};
+
+// Политика проверок по умолчанию: индексы и итераторы не проверяются,
+// итераторы — указатели, и в коде Vector от проверок не остаётся ни ветвлений, ни полей
+struct NoChecks {
+    static constexpr bool kBounds = false;
+    static constexpr bool kIterators = false;
+
+    static void OnViolation(const char*) noexcept {
+    }
+};
+
+// Проверяет индексы operator[] и позиции Insert/Emplace/Erase независимо от NDEBUG.
+// OnViolation не должен возвращать управление; своя политика может бросать исключение
+struct BoundsChecks {
+    static constexpr bool kBounds = true;
+    static constexpr bool kIterators = false;
+
+    [[noreturn]] static void OnViolation(const char* message) noexcept {
+        std::fprintf(stderr, "Vector check failed: %s\n", message);
+        std::abort();
+    }
+};
+
+// Дополнительно заменяет итераторы проверяемыми: они помнят вектор и поколение его буфера
+// и ловят разыменование после перевыделения, выход за [begin, end) и итераторы чужого вектора
+struct IteratorChecks : BoundsChecks {
+    static constexpr bool kIterators = true;
+};
+
+// Буфер Vector вместе с его элементами, отданный через Vector::Release.
+// Разрушает элементы и освобождает память аллокатором, если владение не забрано через Detach
+template <typename T, typename Allocator>
+class VectorBuffer {
+public:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    VectorBuffer() = default;
+
+    VectorBuffer(T* data, size_t size, size_t capacity, const Allocator& alloc) noexcept
+            : alloc_(alloc)
+            , data_(data)
+            , size_(size)
+            , capacity_(capacity) {
+    }
+
+    VectorBuffer(const VectorBuffer& other) = delete;
+    VectorBuffer& operator=(const VectorBuffer& rhs) = delete;
+
+    VectorBuffer(VectorBuffer&& other) noexcept
+            : alloc_(std::move(other.alloc_))
+            , data_(std::exchange(other.data_, nullptr))
+            , size_(std::exchange(other.size_, 0))
+            , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    VectorBuffer& operator=(VectorBuffer&& rhs) noexcept {
+        if (this != &rhs) {
+            Reset();
+            alloc_ = std::move(rhs.alloc_);
+            data_ = std::exchange(rhs.data_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~VectorBuffer() {
+        Reset();
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Отказывается от владения: разрушить элементы и освободить память должен вызывающий
+    T* Detach() noexcept {
+        size_ = 0;
+        capacity_ = 0;
+        return std::exchange(data_, nullptr);
+    }
+
+private:
+    void Reset() noexcept {
+        if (data_ != nullptr) {
+            for (size_t i = 0; i < size_; ++i) {
+                alloc_traits::destroy(alloc_, data_ + i);
+            }
+            alloc_traits::deallocate(alloc_, data_, capacity_);
+            data_ = nullptr;
+        }
+    }
+
+    Allocator alloc_;
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+// Storage — владелец буфера: RawMemory либо хранилище со встроенным буфером
+// (см. SmallMemory), которое переходит на RawMemory при росте за kInlineCapacity.
+// Allocator может быть задан для другого типа (например, Aligned<64>) и приводится к T.
+// CheckPolicy (NoChecks, BoundsChecks, IteratorChecks) выбирается для типа вектора, а не для
+// сборки, поэтому проверяемые векторы можно включить в отдельных местах без пересборки остального.
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          typename StatsPolicy = NoStats,
+          typename Storage = RawMemory<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>,
+          typename CheckPolicy = NoChecks>
 class Vector {
+    template <typename U>
+    class CheckedIterator;
+
 public:
+    using value_type = T;
+    using growth_policy = GrowthPolicy;
+    using stats_policy = StatsPolicy;
+    using check_policy = CheckPolicy;
+    using allocator_type = typename Storage::allocator_type;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    // Для таких типов время жизни элементов начинается неявно при выделении памяти,
+    // и пропуск инициализации (default_init, ResizeDefaultInit) ничего не нарушает
+    static constexpr bool kDefaultInitIsNoop = std::is_trivially_default_constructible_v<T>
+                                               && std::is_trivially_destructible_v<T>
+                                               && detail::kUsesDefaultConstruct<allocator_type, T>;
+
     Vector() = default;
 
-    explicit Vector(size_t size) :
-            data_(size),
+    explicit Vector(const allocator_type& alloc) noexcept :
+            data_(alloc)
+    {}
+
+    explicit Vector(size_t size, const allocator_type& alloc = allocator_type()) :
+            data_(size, alloc),
+            size_(size){
+        StatsPolicy::OnAllocate(data_.Capacity(), sizeof(T));
+        UninitializedValueConstructN(data_.GetAddress(), size);
+    }
+
+    // Элементы остаются неинициализированными: буфер заполнит вызывающий
+    Vector(size_t size, default_init_t, const allocator_type& alloc = allocator_type()) :
+            data_(size, alloc),
             size_(size){
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        static_assert(kDefaultInitIsNoop, "default_init requires a trivially default constructible and destructible T");
+        StatsPolicy::OnAllocate(data_.Capacity(), sizeof(T));
+    }
+
+    Vector(size_t size, parallel_t policy, const allocator_type& alloc = allocator_type()) :
+            data_(size, alloc){
+        StatsPolicy::OnAllocate(data_.Capacity(), sizeof(T));
+        ParallelConstructN(data_.GetAddress(), size, policy, [this](T* p, size_t) {
+            Construct(p);
+        });
+        size_ = size;
     }
 
     Vector(const Vector& other) :
-            data_(other.size_),
+            Vector(other, alloc_traits::select_on_container_copy_construction(other.data_.GetAllocator()))
+    {}
+
+    Vector(const Vector& other, parallel_t policy) :
+            data_(other.size_, alloc_traits::select_on_container_copy_construction(other.data_.GetAllocator())){
+        StatsPolicy::OnAllocate(data_.Capacity(), sizeof(T));
+        const T* src = other.data_.GetAddress();
+        ParallelConstructN(data_.GetAddress(), other.size_, policy, [this, src](T* p, size_t i) {
+            Construct(p, src[i]);
+        });
+        size_ = other.size_;
+    }
+
+    Vector(const Vector& other, const allocator_type& alloc) :
+            data_(other.size_, alloc),
             size_(other.size_){
-        std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+        StatsPolicy::OnAllocate(data_.Capacity(), sizeof(T));
+        UninitializedCopyN(other.data_.GetAddress(), other.size_, data_.GetAddress());
     }
 
-    Vector(Vector&& other) :
-            data_(std::move(other.data_)),
-            size_(std::exchange(other.size_, 0))
-    {}
+    Vector(Vector&& other) noexcept(kNothrowStorageSwap) :
+            data_(other.data_.GetAllocator()){
+        StealFrom(other);
+    }
 
     ~Vector(){
-        std::destroy_n(data_.GetAddress(), size_);
+        DestroyN(data_.GetAddress(), size_);
     }
 
-    using iterator = T*;
-    using const_iterator = const T*;
+    using iterator = std::conditional_t<CheckPolicy::kIterators, CheckedIterator<T>, T*>;
+    using const_iterator = std::conditional_t<CheckPolicy::kIterators, CheckedIterator<const T>, const T*>;
 
     iterator begin() noexcept{
-        return data_.GetAddress();
+        return MakeIterator(data_.GetAddress());
     }
     iterator end() noexcept{
-        return data_.GetAddress() + size_;
+        return MakeIterator(data_.GetAddress() + size_);
     }
     const_iterator begin() const noexcept{
-        return data_.GetAddress();
+        return MakeIterator(data_.GetAddress());
     }
     const_iterator end() const noexcept{
-        return data_.GetAddress() + size_;
+        return MakeIterator(data_.GetAddress() + size_);
     }
     const_iterator cbegin() const noexcept{
-        return data_.GetAddress();
+        return begin();
     }
     const_iterator cend() const noexcept{
-        return data_.GetAddress() + size_;
+        return end();
+    }
+
+    // Указатель на буфер; доступ через него не проверяется ни в одном режиме
+    T* Data() noexcept {
+        return data_.GetAddress();
     }
 
+    const T* Data() const noexcept {
+        return data_.GetAddress();
+    }
 
+    allocator_type GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
 
 
     void CopyVector(const Vector& other){
@@ -142,21 +798,32 @@ public:
                   data_.GetAddress());
 
         if (size_ <= other.size_) {
-            std::uninitialized_copy_n(other.data_.GetAddress() + size_,
-                                      other.size_ - size_,
-                                      data_.GetAddress() + size_);
+            UninitializedCopyN(other.data_.GetAddress() + size_,
+                               other.size_ - size_,
+                               data_.GetAddress() + size_);
         }else{
-            std::destroy_n(data_.GetAddress() + other.size_,
-                           size_ - other.size_);
+            DestroyN(data_.GetAddress() + other.size_,
+                     size_ - other.size_);
         }
         size_ = other.size_;
     }
     Vector& operator=(const Vector& other) {
         if (this != &other) {
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (data_.GetAllocator() != other.data_.GetAllocator()) {
+                    // Память, выделенную старым аллокатором, нужно вернуть ему же
+                    DestroyN(data_.GetAddress(), size_);
+                    size_ = 0;
+                    data_ = Storage(other.data_.GetAllocator());
+                    generation_.Bump();
+                } else {
+                    data_.GetAllocator() = other.data_.GetAllocator();
+                }
+            }
             if (other.size_ <= data_.Capacity()) {
                CopyVector(other);
             } else {
-                Vector other_copy(other);
+                Vector other_copy(other, data_.GetAllocator());
                 Swap(other_copy);
             }
         }
@@ -164,132 +831,275 @@ public:
         return *this;
     }
 
-    Vector& operator=(Vector&& other) noexcept {
+    Vector& operator=(Vector&& other) noexcept(kNothrowStorageSwap
+                                               && (alloc_traits::propagate_on_container_move_assignment::value
+                                                   || alloc_traits::is_always_equal::value)) {
         if(this != &other) {
-            Swap(other);
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                using std::swap;
+                swap(data_.GetAllocator(), other.data_.GetAllocator());
+                SwapStorage(other);
+            } else if (data_.GetAllocator() == other.data_.GetAllocator()) {
+                SwapStorage(other);
+            } else {
+                // Чужой буфер забрать нельзя: перемещаем элементы в память своего аллокатора
+                Vector moved(data_.GetAllocator());
+                moved.Reserve(other.size_);
+                UninitializedMoveN(other.data_.GetAddress(), other.size_, moved.data_.GetAddress());
+                moved.size_ = other.size_;
+                SwapStorage(moved);
+            }
         }
         return *this;
     }
 
-    void Swap(Vector& other) noexcept {
+    void Swap(Vector& other) noexcept(kNothrowStorageSwap) {
         if(this != &other) {
-            data_.Swap(other.data_);
-            std::swap(size_, other.size_);
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(data_.GetAllocator(), other.data_.GetAllocator());
+            } else {
+                assert(data_.GetAllocator() == other.data_.GetAllocator());
+            }
+            SwapStorage(other);
         }
     }
 
-    void Reserve(size_t new_capacity){
+    // site — место вызова для ReallocationEvent; передавать его явно не нужно
+    void Reserve(size_t new_capacity, CallSite site = CallSite::Current()){
         if(data_.Capacity() >= new_capacity){
             return;
         }
 
-        RawMemory<T> new_data(new_capacity);
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-        } else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-        }
-        std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
+        Reallocate(new_capacity, size_, 0, [](T*) {}, site);
     }
 
-    void Resize(size_t new_size){
-        Reserve(new_size);
+    void Resize(size_t new_size, CallSite site = CallSite::Current()){
+        Reserve(new_size, site);
         if(new_size > size_){
-            std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+            UninitializedValueConstructN(data_.GetAddress() + size_, new_size - size_);
         }else{
-            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+            DestroyN(data_.GetAddress() + new_size, size_ - new_size);
         }
         size_ = new_size;
+        MaybeShrink(site);
     }
 
-    template <typename Obj>
-    void PushBack(Obj&& obj){
-        if(size_ >= data_.Capacity()){
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            new (new_data.GetAddress() + size_) T(std::forward<Obj>(obj));
-
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            } else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
+    // Как Resize, но новые элементы создаются параллельно
+    void Resize(size_t new_size, parallel_t policy, CallSite site = CallSite::Current()){
+        Reserve(new_size, site);
+        if(new_size > size_){
+            ParallelConstructN(data_.GetAddress() + size_, new_size - size_, policy, [this](T* p, size_t) {
+                Construct(p);
+            });
         }else{
-            new(data_.GetAddress() + size_) T(std::forward<Obj>(obj));
+            DestroyN(data_.GetAddress() + new_size, size_ - new_size);
         }
-        size_ ++;
+        size_ = new_size;
+        MaybeShrink(site);
     }
 
-    template <typename... Args>
-    T& EmplaceBack(Args&&... args){
-        return *Emplace(end(), std::forward<Args>(args)...);
+    // Уменьшает ёмкость до размера; для SmallVector возвращает элементы во встроенный буфер
+    void ShrinkToFit(CallSite site = CallSite::Current()){
+        if(size_ < data_.Capacity()){
+            ShrinkTo(size_, site);
+        }
+    }
+
+    // Разрушает элементы, сохраняя ёмкость
+    void Clear() noexcept{
+        DestroyN(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    // Разрушает элементы и возвращает буфер аллокатору
+    void ClearAndRelease() noexcept{
+        Clear();
+        data_ = Storage(data_.GetAllocator());
+        generation_.Bump();
+    }
+
+    // Как Resize, но новые элементы не инициализируются
+    void ResizeDefaultInit(size_t new_size, CallSite site = CallSite::Current()){
+        static_assert(kDefaultInitIsNoop, "ResizeDefaultInit requires a trivially default constructible and destructible T");
+        Reserve(new_size, site);
+        size_ = new_size;
+    }
+
+    // Добавляет n неинициализированных элементов и возвращает их для заполнения,
+    // например чтением из сокета. Ссылка действительна до следующего перевыделения.
+    Span<T> AppendUninitialized(size_t n, CallSite site = CallSite::Current()){
+        static_assert(kDefaultInitIsNoop, "AppendUninitialized requires a trivially default constructible and destructible T");
+        if(size_ + n > data_.Capacity()){
+            Reserve(NextCapacity(size_ + n), site);
+        }
+        size_ += n;
+        return Span<T>(data_.GetAddress() + size_ - n, n);
+    }
+
+    // Добавляет n элементов, созданных по умолчанию, не более чем с одним перевыделением
+    void AppendDefault(size_t n, CallSite site = CallSite::Current()){
+        if(size_ + n > data_.Capacity()){
+            Reserve(NextCapacity(size_ + n), site);
+        }
+        UninitializedValueConstructN(data_.GetAddress() + size_, n);
+        size_ += n;
+    }
+
+    template <typename InputIt>
+    void Append(InputIt first, InputIt last, CallSite site = CallSite::Current()){
+        Insert(cend(), first, last, site);
+    }
+
+    // Вставка диапазона за одно перевыделение и один сдвиг хвоста (для прямых итераторов).
+    // Итераторы не должны указывать на элементы *this.
+    template <typename InputIt,
+              typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+                      typename std::iterator_traits<InputIt>::iterator_category>>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last, CallSite site = CallSite::Current()){
+        const size_t position = PositionOf(pos);
+
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            return InsertRange(position, static_cast<size_t>(std::distance(first, last)), first, site);
+        } else {
+            // Однопроходный диапазон: дописываем в конец и поворачиваем на место
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceAtIndex(site, size_, *first);
+            }
+            T* data = data_.GetAddress();
+            std::rotate(data + position, data + old_size, data + size_);
+            return MakeIterator(data + position);
+        }
+    }
+
+    iterator Insert(const_iterator pos, size_t count, const T& value, CallSite site = CallSite::Current()){
+        const size_t position = PositionOf(pos);
+        if (AliasesElements(value)) {
+            // value лежит внутри вектора и может быть сдвинут при вставке
+            const T copy(value);
+            return InsertRange(position, count, detail::RepeatIterator<T>(copy, 0), site);
+        }
+        return InsertRange(position, count, detail::RepeatIterator<T>(value, 0), site);
+    }
+
+    template <typename Obj>
+    void PushBack(Obj&& obj, CallSite site = CallSite::Current()){
+        if(size_ >= data_.Capacity()){
+            Reallocate(NextCapacity(size_ + 1), size_, 1, [this, &obj](T* slot) {
+                Construct(slot, std::forward<Obj>(obj));
+            }, site);
+        }else{
+            Construct(data_.GetAddress() + size_, std::forward<Obj>(obj));
+        }
+        size_ ++;
+    }
+
+    // После пакета аргументов нельзя поставить CallSite по умолчанию, поэтому перевыделения
+    // из EmplaceBack и Emplace приходят без места вызова; EmplaceBackAt и EmplaceAt
+    // принимают его явно: v.EmplaceBackAt(CallSite::Current(), args...)
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args){
+        return *EmplaceAtIndex(CallSite(), size_, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    T& EmplaceBackAt(CallSite site, Args&&... args){
+        return *EmplaceAtIndex(site, size_, std::forward<Args>(args)...);
     }
 
     void PopBack(){
         if(size_ > 0){
-            std::destroy_at(data_.GetAddress() + size_ - 1);
+            Destroy(data_.GetAddress() + size_ - 1);
             size_ --;
+            MaybeShrink();
         }
     }
 
+    // Строгая гарантия исключений при вставке в конец, при перевыделении, для побайтово
+    // переносимых T и для T с небросающими перемещением и присваиванием перемещением;
+    // в остальных случаях вставки в середину — базовая
     template <typename... Args>
     iterator Emplace(const_iterator pos, Args&&... args){
-        assert(pos >= begin() && pos <= end());
-        auto position = pos - begin();
+        return MakeIterator(EmplaceAtIndex(CallSite(), PositionOf(pos), std::forward<Args>(args)...));
+    }
 
-        if(size_ < data_.Capacity()){
-            try{
-                if(pos == end()){
-                    new (end()) T(std::forward<Args>(args)...);
-                }else{
-                    T new_item(std::forward<Args>(args)...);
-                    new (end()) T(std::forward<T>(data_[size_ - 1]));
-                    std::move_backward(begin() + position, end() - 1, end());
-                    *(begin() + position) = std::forward<T>(new_item);
-                }
-            }catch (...){
-                operator delete(end());
-                throw;
-            }
-        }else{
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            new (new_data.GetAddress() + position) T(std::forward<Args>(args)...);
+    template <typename... Args>
+    iterator EmplaceAt(CallSite site, const_iterator pos, Args&&... args){
+        return MakeIterator(EmplaceAtIndex(site, PositionOf(pos), std::forward<Args>(args)...));
+    }
 
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(begin(), position, new_data.GetAddress());
-                std::uninitialized_move_n(begin() + position, size_ - position, new_data.GetAddress() + position + 1);
-            } else {
-                std::uninitialized_copy_n(begin(), position, new_data.GetAddress());
-                std::uninitialized_copy_n(begin() + position, size_ - position, new_data.GetAddress() + position + 1);
-            }
+    iterator Insert(const_iterator pos, const T& value, CallSite site = CallSite::Current()){
+        return MakeIterator(EmplaceAtIndex(site, PositionOf(pos), value));
+    }
 
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
-        }
-        size_++;
-        return begin() + position;
+    iterator Insert(const_iterator pos, T&& value, CallSite site = CallSite::Current()){
+        return MakeIterator(EmplaceAtIndex(site, PositionOf(pos), std::move(value)));
     }
 
-    iterator Insert(const_iterator pos, const T& value){
-        return Emplace(pos, value);
+    // Проверяемые режимы ловят pos == end() на pos + 1
+    iterator Erase(const_iterator pos) {
+        return Erase(pos, pos + 1);
     }
 
-    iterator Insert(const_iterator pos, T&& value){
-        return Emplace(pos, std::move(value));
+    iterator Erase(const_iterator first, const_iterator last) {
+        const size_t position = PositionOf(first);
+        const size_t end_position = PositionOf(last);
+        if constexpr (CheckPolicy::kBounds) {
+            if (position > end_position) {
+                CheckPolicy::OnViolation("Erase: first is past last");
+            }
+        }
+        assert(position <= end_position);
+        const size_t count = end_position - position;
+        if (count == 0) {
+            return MakeIterator(data_.GetAddress() + position);
+        }
+
+        T* gap = data_.GetAddress() + position;
+        T* old_end = data_.GetAddress() + size_;
+        if constexpr (kRelocateBitwise) {
+            DestroyN(gap, count);
+            std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count),
+                         (size_ - position - count) * sizeof(T));
+        } else {
+            std::move(gap + count, old_end, gap);
+            DestroyN(old_end - count, count);
+        }
+        size_ -= count;
+        MaybeShrink();
+
+        return MakeIterator(data_.GetAddress() + position);
     }
 
-    iterator Erase(const_iterator pos) {
-        assert(pos >= begin() && pos < end());
-        auto position = pos - begin();
+    // Отдаёт буфер с элементами без копирования; вектор остаётся пустым
+    VectorBuffer<T, allocator_type> Release() noexcept {
+        static_assert(Storage::kInlineCapacity == 0, "Release requires heap-only storage");
+        const size_t size = std::exchange(size_, 0);
+        const size_t capacity = data_.Capacity();
+        generation_.Bump();
+        return VectorBuffer<T, allocator_type>(data_.Release(), size, capacity, data_.GetAllocator());
+    }
 
-        std::move(begin() + position + 1, end(), begin() + position);
-        std::destroy_at(end() - 1);
-        size_--;
+    // Забирает буфер на capacity элементов, выделенный аллокатором, равным GetAllocator(),
+    // первые size элементов которого уже созданы. Прежние элементы разрушаются.
+    // Для MallocAllocator подходит буфер, полученный от malloc в C-библиотеке; буферы
+    // MmapAllocator от kMmapThreshold байт освобождаются через munmap и для этого не годятся.
+    void Adopt(T* data, size_t size, size_t capacity) noexcept {
+        static_assert(Storage::kInlineCapacity == 0, "Adopt requires heap-only storage");
+        assert(size <= capacity && (data != nullptr || capacity == 0));
+        Clear();
+        data_.Adopt(data, capacity);
+        size_ = size;
+        generation_.Bump();
+    }
 
-        return (begin() + position);
+    void Adopt(VectorBuffer<T, allocator_type>&& buffer) noexcept {
+        assert(buffer.GetAllocator() == data_.GetAllocator());
+        const size_t size = buffer.Size();
+        const size_t capacity = buffer.Capacity();
+        Adopt(buffer.Detach(), size, capacity);
     }
 
     size_t Size() const noexcept {
@@ -300,42 +1110,717 @@ public:
         return data_.Capacity();
     }
 
-    const T& operator[](size_t index) const noexcept {
+    const T& operator[](size_t index) const noexcept(!CheckPolicy::kBounds) {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    T& operator[](size_t index) noexcept(!CheckPolicy::kBounds) {
+        if constexpr (CheckPolicy::kBounds) {
+            if (index >= size_) {
+                CheckPolicy::OnViolation("operator[]: index out of range");
+            }
+        }
         assert(index < size_);
         return data_[index];
     }
 
 private:
-    RawMemory<T> data_;
+    Storage data_;
     size_t size_ = 0;
+    [[no_unique_address]] detail::BufferGeneration<CheckPolicy::kIterators> generation_;
+
+    iterator MakeIterator(T* p) noexcept {
+        if constexpr (CheckPolicy::kIterators) {
+            return iterator(this, p);
+        } else {
+            return p;
+        }
+    }
+
+    const_iterator MakeIterator(const T* p) const noexcept {
+        if constexpr (CheckPolicy::kIterators) {
+            return const_iterator(this, p);
+        } else {
+            return p;
+        }
+    }
 
-    static T* AllocateN(size_t n){
-        if(n > 0) {
-            return static_cast<T *>(operator new(n * sizeof(T)));
+    // Индекс позиции pos из [begin, end]; в режимах проверок неверная позиция — нарушение
+    size_t PositionOf(const_iterator pos) const noexcept(!CheckPolicy::kBounds) {
+        const T* p;
+        if constexpr (CheckPolicy::kIterators) {
+            pos.CheckValid();
+            p = pos.ptr_;
+        } else {
+            p = pos;
+        }
+        const T* first = data_.GetAddress();
+        if constexpr (CheckPolicy::kBounds) {
+            if (std::less<const T*>()(p, first) || std::less<const T*>()(first + size_, p)) {
+                CheckPolicy::OnViolation("position is outside [begin, end]");
+            }
+        }
+        assert(p >= first && p <= first + size_);
+        return static_cast<size_t>(p - first);
+    }
+
+    // Вставка на позицию position; возвращает указатель на новый элемент
+    template <typename... Args>
+    T* EmplaceAtIndex(CallSite site, size_t position, Args&&... args){
+        if(size_ < data_.Capacity()){
+            if(position == size_){
+                Construct(data_.GetAddress() + size_, std::forward<Args>(args)...);
+                size_++;
+            }else{
+                EmplaceInMiddle(position, std::forward<Args>(args)...);
+            }
         }else{
-            return nullptr;
+            Reallocate(NextCapacity(size_ + 1), position, 1, [&](T* slot) {
+                Construct(slot, std::forward<Args>(args)...);
+            }, site);
+            size_++;
+        }
+        return data_.GetAddress() + position;
+    }
+
+    size_t NextCapacity(size_t required) const noexcept {
+        return GrowthPolicy::NextCapacity(data_.Capacity(), required, sizeof(T));
+    }
+
+    // Проверяет, ссылается ли какой-либо из аргументов внутрь живых элементов вектора
+    template <typename... Args>
+    bool AliasesElements(const Args&... args) const noexcept {
+        [[maybe_unused]] const void* first = data_.GetAddress();
+        [[maybe_unused]] const void* last = data_.GetAddress() + size_;
+        return (... || (std::less_equal<const void*>()(first, static_cast<const void*>(std::addressof(args)))
+                        && std::less<const void*>()(static_cast<const void*>(std::addressof(args)), last)));
+    }
+
+    // Вставка внутрь буфера, в котором есть свободное место. Если аргументы не ссылаются
+    // на элементы вектора, элемент строится сразу на своём месте; иначе — во временном объекте
+    template <typename... Args>
+    void EmplaceInMiddle(size_t position, Args&&... args) {
+        T* gap = data_.GetAddress() + position;
+        const size_t elems_after = size_ - position;
+
+        if constexpr (kRelocateBitwise) {
+            if (!AliasesElements(args...)) {
+                std::memmove(static_cast<void*>(gap + 1), static_cast<const void*>(gap), elems_after * sizeof(T));
+                try {
+                    Construct(gap, std::forward<Args>(args)...);
+                } catch (...) {
+                    std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + 1), elems_after * sizeof(T));
+                    throw;
+                }
+            } else {
+                alignas(T) unsigned char storage[sizeof(T)];
+                T* item = reinterpret_cast<T*>(storage);
+                Construct(item, std::forward<Args>(args)...);
+                std::memmove(static_cast<void*>(gap + 1), static_cast<const void*>(gap), elems_after * sizeof(T));
+                std::memcpy(static_cast<void*>(gap), static_cast<const void*>(item), sizeof(T));
+            }
+            size_++;
+        } else {
+            T* last = data_.GetAddress() + size_;
+            if constexpr (std::is_nothrow_constructible_v<T, Args&&...> && std::is_nothrow_move_constructible_v<T>
+                          && std::is_nothrow_move_assignable_v<T>) {
+                if (!AliasesElements(args...)) {
+                    Construct(last, std::move(last[-1]));
+                    size_++;
+                    std::move_backward(gap, last - 1, last);
+                    Destroy(gap);
+                    Construct(gap, std::forward<Args>(args)...);
+                    return;
+                }
+            }
+
+            T new_item(std::forward<Args>(args)...);
+            Construct(last, std::move_if_noexcept(last[-1]));
+            size_++;
+            std::move_backward(gap, last - 1, last);
+            *gap = std::move(new_item);
+        }
+    }
+
+    template <typename ForwardIt>
+    void UninitializedCopyRange(ForwardIt first, size_t n, T* dst) {
+        UninitializedConstructN(dst, n, [this, &first](T* p, size_t) {
+            Construct(p, *first);
+            ++first;
+        });
+    }
+
+    // Вставляет n элементов [first, first + n) на позицию position
+    template <typename ForwardIt>
+    iterator InsertRange(size_t position, size_t n, ForwardIt first, CallSite site) {
+        if (n == 0) {
+            return MakeIterator(data_.GetAddress() + position);
+        }
+
+        if (size_ + n > data_.Capacity()) {
+            Reallocate(NextCapacity(size_ + n), position, n, [this, n, &first](T* slot) {
+                UninitializedCopyRange(first, n, slot);
+            }, site);
+            size_ += n;
+            return MakeIterator(data_.GetAddress() + position);
+        }
+
+        T* gap = data_.GetAddress() + position;
+        T* old_end = data_.GetAddress() + size_;
+        const size_t elems_after = size_ - position;
+
+        if constexpr (kRelocateBitwise) {
+            // Хвост сдвигается одним memmove, при исключении возвращается на место
+            std::memmove(static_cast<void*>(gap + n), static_cast<const void*>(gap), elems_after * sizeof(T));
+            try {
+                UninitializedCopyRange(first, n, gap);
+            } catch (...) {
+                std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + n), elems_after * sizeof(T));
+                throw;
+            }
+            size_ += n;
+        } else if (elems_after > n) {
+            UninitializedMoveN(old_end - n, n, old_end);
+            size_ += n;
+            std::move_backward(gap, old_end - n, old_end);
+            std::copy_n(first, n, gap);
+        } else {
+            ForwardIt mid = std::next(first, elems_after);
+            UninitializedCopyRange(mid, n - elems_after, old_end);
+            try {
+                UninitializedMoveN(gap, elems_after, old_end + n - elems_after);
+            } catch (...) {
+                DestroyN(old_end, n - elems_after);
+                throw;
+            }
+            size_ += n;
+            std::copy(first, mid, gap);
+        }
+        return MakeIterator(gap);
+    }
+
+    void ShrinkTo(size_t new_capacity, CallSite site) {
+        assert(size_ <= new_capacity && new_capacity < data_.Capacity());
+        if constexpr (Storage::kInlineCapacity != 0) {
+            if (new_capacity <= Storage::kInlineCapacity) {
+                if (!data_.IsInline()) {
+                    MoveToInlineBuffer();
+                }
+                return;
+            }
         }
+        Reallocate(new_capacity, size_, 0, [](T*) {}, site);
     }
 
-    static void Deallocate(T* data) noexcept {
-        operator delete (data);
+    void MoveToInlineBuffer() {
+        RawMemory<T, allocator_type> heap(data_.GetAllocator());
+        data_.Swap(heap);
+        try {
+            RelocateN(heap.GetAddress(), size_, data_.GetAddress());
+        } catch (...) {
+            data_.Swap(heap);
+            throw;
+        }
+        DestroyRelocatedN(heap.GetAddress(), size_);
+        generation_.Bump();
     }
 
-    static void Destroy(T* data) noexcept{
-        data->~T();
+    void MaybeShrink(CallSite site = CallSite()) noexcept {
+        if constexpr (detail::HasShrinkCapacity<GrowthPolicy>::value) {
+            const size_t new_capacity = GrowthPolicy::ShrinkCapacity(data_.Capacity(), size_, sizeof(T));
+            if (new_capacity < data_.Capacity()) {
+                // Сжатие — лишь оптимизация: при нехватке памяти вектор остаётся с прежним буфером
+                try {
+                    ShrinkTo(new_capacity, site);
+                } catch (...) {
+                }
+            }
+        }
     }
 
-    static void DestroyN(T* data, size_t n) noexcept{
+    // Буферы в куче обмениваются указателями, встроенные — поэлементным переносом
+    static constexpr bool kNothrowStorageSwap = Storage::kInlineCapacity == 0
+                                                || std::is_nothrow_move_constructible_v<T>
+                                                || is_trivially_relocatable_v<T>;
+
+    void SwapStorage(Vector& other) noexcept(kNothrowStorageSwap) {
+        if constexpr (Storage::kInlineCapacity == 0) {
+            data_.Swap(other.data_);
+            std::swap(size_, other.size_);
+            generation_.Bump();
+            other.generation_.Bump();
+        } else {
+            Vector tmp(data_.GetAllocator());
+            tmp.StealFrom(other);
+            if constexpr (kNothrowStorageSwap) {
+                other.StealFrom(*this);
+                StealFrom(tmp);
+            } else {
+                // Неудачный StealFrom оставляет источник нетронутым, поэтому при исключении
+                // возвращаем уже перенесённые элементы на место
+                try {
+                    other.StealFrom(*this);
+                } catch (...) {
+                    RestoreFrom(other, tmp);
+                    throw;
+                }
+                try {
+                    StealFrom(tmp);
+                } catch (...) {
+                    RestoreFrom(*this, other);
+                    RestoreFrom(other, tmp);
+                    throw;
+                }
+            }
+        }
+    }
+
+    // Возвращает элементы из from в опустевший to. Буфер в куче переходит без копирования;
+    // если не удаётся скопировать и встроенные элементы, они теряются, но оба вектора остаются целыми
+    static void RestoreFrom(Vector& to, Vector& from) noexcept {
+        try {
+            to.StealFrom(from);
+        } catch (...) {
+        }
+    }
+
+    // Забирает элементы other в пустой *this (без живых элементов); other остаётся пустым
+    void StealFrom(Vector& other) noexcept(kNothrowStorageSwap) {
+        assert(size_ == 0);
+        generation_.Bump();
+        other.generation_.Bump();
+        if constexpr (Storage::kInlineCapacity != 0) {
+            if (other.data_.IsInline()) {
+                RelocateN(other.data_.GetAddress(), other.size_, data_.GetAddress());
+                DestroyRelocatedN(other.data_.GetAddress(), other.size_);
+                size_ = std::exchange(other.size_, 0);
+                return;
+            }
+        }
+        data_ = std::move(other.data_);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    template <typename... Args>
+    void Construct(T* data, Args&&... args) {
+        alloc_traits::construct(data_.GetAllocator(), data, std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* data) noexcept{
+        alloc_traits::destroy(data_.GetAllocator(), data);
+    }
+
+    void DestroyN(T* data, size_t n) noexcept{
         for(size_t i = 0; i < n; i++){
             Destroy(data + i);
         }
     }
 
-    static void CopyConstruct(T* data, const T& elem) {
-        new (data) T(elem);
+    // Конструирует [dst, dst + n) вызовами construct(dst + i, make(i)...);
+    // при исключении уже созданные элементы разрушаются
+    template <typename Maker>
+    void UninitializedConstructN(T* dst, size_t n, Maker make) {
+        size_t i = 0;
+        try {
+            for (; i < n; ++i) {
+                make(dst + i, i);
+            }
+        } catch (...) {
+            DestroyN(dst, i);
+            throw;
+        }
+    }
+
+    void UninitializedValueConstructN(T* dst, size_t n) {
+        UninitializedConstructN(dst, n, [this](T* p, size_t) { Construct(p); });
+    }
+
+    void UninitializedCopyN(const T* src, size_t n, T* dst) {
+        UninitializedConstructN(dst, n, [this, src](T* p, size_t i) { Construct(p, src[i]); });
+    }
+
+    void UninitializedMoveN(T* src, size_t n, T* dst) {
+        UninitializedConstructN(dst, n, [this, src](T* p, size_t i) { Construct(p, std::move(src[i])); });
+    }
+
+    // Как UninitializedConstructN, но части диапазона создаются в разных потоках.
+    // Если хоть одна часть бросила, созданные части разрушаются и пробрасывается первое исключение
+    template <typename Maker>
+    void ParallelConstructN(T* dst, size_t n, parallel_t policy, const Maker& make) {
+        const size_t chunk = detail::ParallelChunkSize(n, sizeof(T), policy.threads);
+        if (chunk >= n) {
+            UninitializedConstructN(dst, n, make);
+            return;
+        }
+        const size_t chunks = (n + chunk - 1) / chunk;
+        std::unique_ptr<bool[]> built(new bool[chunks]());
+        std::exception_ptr error;
+        detail::ParallelFor(chunks, [&](size_t index) {
+            const size_t first = index * chunk;
+            UninitializedConstructN(dst + first, std::min(chunk, n - first), [&make, first](T* p, size_t i) {
+                make(p, first + i);
+            });
+            built[index] = true;
+        }, error);
+        if (error) {
+            for (size_t index = 0; index < chunks; ++index) {
+                if (built[index]) {
+                    DestroyN(dst + index * chunk, std::min(chunk, n - index * chunk));
+                }
+            }
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Побайтовый перенос допустим, только если аллокатор не переопределяет construct/destroy
+    static constexpr bool kRelocateBitwise = is_trivially_relocatable_v<T>
+                                             && detail::kUsesDefaultConstruct<allocator_type, T>;
+
+    // Перенос элементов в новый буфер: перемещение, если оно не бросает
+    // (или копирование невозможно), иначе копирование ради строгой гарантии
+    void RelocateN(T* src, size_t n, T* dst) {
+        if constexpr (kRelocateBitwise) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+            }
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            UninitializedMoveN(src, n, dst);
+        } else {
+            UninitializedCopyN(src, n, dst);
+        }
+    }
+
+    // Разрушает исходные элементы после успешного RelocateN
+    void DestroyRelocatedN(T* src, size_t n) noexcept {
+        if constexpr (!kRelocateBitwise) {
+            DestroyN(src, n);
+        }
+    }
+
+    static constexpr bool kGrowInPlace = kRelocateBitwise
+                                         && detail::HasReallocateMember<allocator_type, T>::value;
+
+    // Перевыделения замеряются и описываются, только если их кто-то наблюдает
+    static constexpr bool kTraceReallocations = StatsPolicy::kEnabled || detail::kUsdtProbes;
+
+    using ReallocationTimer = detail::ReallocationTimer<kTraceReallocations>;
+
+    // Рост в конце через RawMemory::Reallocate. Аргументы fill могут ссылаться на элементы,
+    // которые realloc перенесёт, поэтому новый элемент заранее строится во временной памяти
+    template <typename Fill>
+    void GrowInPlace(size_t new_capacity, size_t gap, Fill& fill, CallSite site, const ReallocationTimer& timer) {
+        assert(gap <= 1);
+        const size_t old_capacity = data_.Capacity();
+        alignas(T) unsigned char storage[sizeof(T)];
+        T* item = reinterpret_cast<T*>(storage);
+        if (gap != 0) {
+            fill(item);
+        }
+
+        try {
+            data_.Reallocate(new_capacity);
+            generation_.Bump();
+        } catch (...) {
+            if (gap != 0) {
+                Destroy(item);
+            }
+            throw;
+        }
+
+        if (gap != 0) {
+            std::memcpy(static_cast<void*>(data_.GetAddress() + size_), static_cast<const void*>(item), sizeof(T));
+        }
+        ReportReallocation(old_capacity, new_capacity, size_ + gap, size_, true, site, timer);
+    }
+
+    // Перевыделяет буфер ёмкостью new_capacity, оставляя gap неинициализированных слотов
+    // на позиции position. fill(slot) заполняет их до переноса элементов, поэтому его
+    // аргументы могут ссылаться на элементы старого буфера. Строгая гарантия исключений.
+    template <typename Fill>
+    void Reallocate(size_t new_capacity, size_t position, size_t gap, Fill&& fill, CallSite site) {
+        assert(position <= size_ && size_ + gap <= new_capacity);
+        const ReallocationTimer timer;
+        if constexpr (detail::HasExpandInPlaceMember<allocator_type, T>::value) {
+            // Буфер удлинён без переноса: элементы на месте, ссылки в fill остаются верными
+            const size_t old_capacity = data_.Capacity();
+            if (position == size_ && new_capacity > old_capacity && data_.TryExpandInPlace(new_capacity)) {
+                fill(data_.GetAddress() + position);
+                ReportReallocation(old_capacity, new_capacity, size_ + gap, 0, true, site, timer);
+                return;
+            }
+        }
+        if constexpr (kGrowInPlace) {
+            if (position == size_ && gap <= 1) {
+                GrowInPlace(new_capacity, gap, fill, site, timer);
+                return;
+            }
+        }
+
+        RawMemory<T, allocator_type> new_data(new_capacity, data_.GetAllocator());
+        T* dst = new_data.GetAddress();
+        fill(dst + position);
+
+        try {
+            RelocateN(data_.GetAddress(), position, dst);
+            try {
+                RelocateN(data_.GetAddress() + position, size_ - position, dst + position + gap);
+            } catch (...) {
+                DestroyN(dst, position);
+                throw;
+            }
+        } catch (...) {
+            DestroyN(dst + position, gap);
+            throw;
+        }
+
+        DestroyRelocatedN(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+        generation_.Bump();
+        const size_t old_capacity = new_data.Capacity();
+        if constexpr (kTraceReallocations) {
+            // Освобождение большого буфера (munmap) тоже входит в замер
+            new_data = RawMemory<T, allocator_type>(data_.GetAllocator());
+        }
+        ReportReallocation(old_capacity, new_capacity, size_ + gap, size_, false, site, timer);
+    }
+
+    void ReportReallocation(size_t old_capacity, size_t new_capacity, size_t required, size_t relocated,
+                            bool in_place, CallSite site, const ReallocationTimer& timer) noexcept {
+        if constexpr (kTraceReallocations) {
+            ReallocationEvent event;
+            event.element_size = sizeof(T);
+            event.old_capacity = old_capacity;
+            event.new_capacity = new_capacity;
+            event.required = required;
+            if constexpr (kRelocateBitwise) {
+                event.elements_relocated_bitwise = relocated;
+            } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+                event.elements_moved = relocated;
+            } else {
+                event.elements_copied = relocated;
+            }
+            event.bytes_moved = relocated * sizeof(T);
+            event.elapsed_ns = timer.ElapsedNs();
+            event.in_place = in_place;
+            event.call_site = site;
+            StatsPolicy::OnReallocate(event);
+#ifdef VECTOR_USDT_PROBES
+            STAP_PROBE7(advanced_vector, reallocate, event.element_size, event.old_capacity, event.new_capacity,
+                        event.bytes_moved, event.elapsed_ns, site.file, site.line);
+#endif
+        }
     }
-};
\ No newline at end of file
+
+    // Итератор режима IteratorChecks (U — T или const T). Помнит вектор и поколение его буфера:
+    // любое перевыделение, обмен или перемещение буфера делает итератор недействительным,
+    // и следующее обращение к нему вызывает CheckPolicy::OnViolation.
+    // Поэлементная вставка и удаление без перевыделения поколение не меняют,
+    // поэтому сдвинутые ими итераторы ловятся лишь при выходе за [begin, end)
+    template <typename U>
+    class CheckedIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = U*;
+        using reference = U&;
+
+        CheckedIterator() = default;
+
+        // iterator приводится к const_iterator
+        template <typename V, typename = std::enable_if_t<std::is_same_v<U, const V>>>
+        CheckedIterator(const CheckedIterator<V>& other) noexcept
+                : owner_(other.owner_)
+                , ptr_(other.ptr_)
+                , generation_(other.generation_) {
+        }
+
+        reference operator*() const {
+            CheckDereferenceable();
+            return *ptr_;
+        }
+
+        pointer operator->() const {
+            CheckDereferenceable();
+            return ptr_;
+        }
+
+        reference operator[](difference_type offset) const {
+            return *(*this + offset);
+        }
+
+        CheckedIterator& operator++() {
+            return *this += 1;
+        }
+
+        CheckedIterator operator++(int) {
+            CheckedIterator old = *this;
+            *this += 1;
+            return old;
+        }
+
+        CheckedIterator& operator--() {
+            return *this -= 1;
+        }
+
+        CheckedIterator operator--(int) {
+            CheckedIterator old = *this;
+            *this -= 1;
+            return old;
+        }
+
+        CheckedIterator& operator+=(difference_type offset) {
+            CheckValid();
+            const difference_type index = ptr_ - owner_->data_.GetAddress() + offset;
+            if (index < 0 || static_cast<size_t>(index) > owner_->size_) {
+                CheckPolicy::OnViolation("iterator moved outside [begin, end]");
+            }
+            ptr_ += offset;
+            return *this;
+        }
+
+        CheckedIterator& operator-=(difference_type offset) {
+            return *this += -offset;
+        }
+
+        friend CheckedIterator operator+(CheckedIterator it, difference_type offset) {
+            return it += offset;
+        }
+
+        friend CheckedIterator operator+(difference_type offset, CheckedIterator it) {
+            return it += offset;
+        }
+
+        friend CheckedIterator operator-(CheckedIterator it, difference_type offset) {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+            CheckComparable(lhs, rhs);
+            return lhs.ptr_ - rhs.ptr_;
+        }
+
+        friend bool operator==(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+            CheckComparable(lhs, rhs);
+            return lhs.ptr_ == rhs.ptr_;
+        }
+
+        friend bool operator!=(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+            CheckComparable(lhs, rhs);
+            return lhs.ptr_ < rhs.ptr_;
+        }
+
+        friend bool operator<=(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+            return rhs < lhs;
+        }
+
+        friend bool operator>=(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+            return !(lhs < rhs);
+        }
+
+    private:
+        friend class Vector;
+        template <typename>
+        friend class CheckedIterator;
+
+        const Vector* owner_ = nullptr;
+        U* ptr_ = nullptr;
+        uint64_t generation_ = 0;
+
+        CheckedIterator(const Vector* owner, U* ptr) noexcept
+                : owner_(owner)
+                , ptr_(ptr)
+                , generation_(owner->generation_.value) {
+        }
+
+        void CheckValid() const {
+            if (owner_ == nullptr) {
+                CheckPolicy::OnViolation("singular iterator");
+            }
+            if (generation_ != owner_->generation_.value) {
+                CheckPolicy::OnViolation("iterator used after reallocation");
+            }
+        }
+
+        void CheckDereferenceable() const {
+            CheckValid();
+            const T* first = owner_->data_.GetAddress();
+            if (ptr_ < first || ptr_ >= first + owner_->size_) {
+                CheckPolicy::OnViolation("dereferenced iterator is outside [begin, end)");
+            }
+        }
+
+        // Два сингулярных итератора (созданных по умолчанию) равны, как два nullptr
+        static void CheckComparable(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+            if (lhs.owner_ == nullptr && rhs.owner_ == nullptr) {
+                return;
+            }
+            lhs.CheckValid();
+            rhs.CheckValid();
+            if (lhs.owner_ != rhs.owner_) {
+                CheckPolicy::OnViolation("iterators of different vectors");
+            }
+        }
+    };
+};
+
+// Vector с проверками, не зависящими от NDEBUG: BoundsChecks или IteratorChecks
+template <typename T, typename CheckPolicy = BoundsChecks, typename Allocator = std::allocator<T>>
+using CheckedVector = Vector<T, Allocator, DoublingGrowth, NoStats,
+                             RawMemory<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>,
+                             CheckPolicy>;
+
+namespace detail {
+
+// Устойчивое уплотнение без ветвлений: каждый элемент [in, last) записывается на позицию
+// out < in, а out сдвигается, только если элемент остаётся
+template <typename T, typename Pred>
+T* CompactTriviallyCopyable(T* out, T* in, T* last, Pred& pred) {
+    for (; in != last; ++in) {
+        const bool keep = !pred(static_cast<const T&>(*in));
+        std::memcpy(static_cast<void*>(out), static_cast<const void*>(in), sizeof(T));
+        out += keep;
+    }
+    return out;
+}
+
+}  // namespace detail
+
+// Удаляет элементы, удовлетворяющие pred, за один устойчивый проход с одним
+// разрушением хвоста. pred вызывается ровно один раз для каждого элемента, и всегда
+// один и тот же объект, так что предикат с состоянием видит все вызовы.
+// Возвращает число удалённых элементов.
+template <typename T, typename Allocator, typename GrowthPolicy, typename StatsPolicy, typename Storage,
+          typename CheckPolicy, typename Pred>
+size_t EraseIf(Vector<T, Allocator, GrowthPolicy, StatsPolicy, Storage, CheckPolicy>& v, Pred pred) {
+    T* first = v.Data();
+    T* last = v.Data() + v.Size();
+    first = std::find_if(first, last, std::ref(pred));
+    if (first == last) {
+        return 0;
+    }
+
+    // *first уже удаляется, уплотнение начинается со следующего элемента
+    T* new_end = first;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        new_end = detail::CompactTriviallyCopyable(first, first + 1, last, pred);
+    } else {
+        for (T* in = first + 1; in != last; ++in) {
+            if (!pred(static_cast<const T&>(*in))) {
+                *new_end++ = std::move(*in);
+            }
+        }
+    }
+
+    const size_t removed = last - new_end;
+    v.Erase(v.cend() - removed, v.cend());
+    return removed;
+}
\ No newline at end of file
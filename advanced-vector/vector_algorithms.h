@@ -0,0 +1,752 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstdint>
+#include <type_traits>
+
+// Векторизованные Find, Count, MinElement, MaxElement, Sum и Dot над Vector арифметических типов.
+// Для int32_t и float ядро выбирается во время выполнения по возможностям процессора
+// (AVX-512, AVX2 на x86, NEON на AArch64), остальные типы обрабатываются скалярным кодом.
+// Если аллокатор гарантирует выравнивание буфера (Aligned<64>), ядра читают выровненными загрузками.
+// Сумма float складывается по полосам, поэтому может отличаться от последовательной в младших
+// разрядах; NaN в MinElement/MaxElement не поддерживаются.
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_ALGORITHMS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define VECTOR_ALGORITHMS_NEON 1
+#include <arm_neon.h>
+#endif
+
+enum class SimdIsa {
+    kScalar,
+    kNeon,
+    kAvx2,
+    kAvx512,
+};
+
+inline SimdIsa DetectSimdIsa() noexcept {
+#if defined(VECTOR_ALGORITHMS_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdIsa::kAvx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("popcnt")) {
+        return SimdIsa::kAvx2;
+    }
+#elif defined(VECTOR_ALGORITHMS_NEON)
+    return SimdIsa::kNeon;
+#endif
+    return SimdIsa::kScalar;
+}
+
+// Набор инструкций, который используют алгоритмы; определяется один раз
+inline SimdIsa ActiveSimdIsa() noexcept {
+    static const SimdIsa isa = DetectSimdIsa();
+    return isa;
+}
+
+namespace detail::simd {
+
+template <typename T>
+using SumType = std::conditional_t<std::is_floating_point_v<T>, T,
+                                   std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+template <typename T>
+inline constexpr bool kVectorizable = std::is_same_v<T, int32_t> || std::is_same_v<T, float>;
+
+// Выравнивание, которое аллокатор обещает для начала буфера (0 — только alignof(T))
+template <typename Alloc, typename = void>
+struct AllocatorAlignment : std::integral_constant<size_t, 0> {};
+
+template <typename Alloc>
+struct AllocatorAlignment<Alloc, std::void_t<decltype(Alloc::kAlignment)>>
+        : std::integral_constant<size_t, Alloc::kAlignment> {};
+
+// Встроенный буфер SmallVector выделен не аллокатором, и его выравнивание не гарантировано
+template <typename Vec, typename Storage>
+inline constexpr size_t kBufferAlignment = Storage::kInlineCapacity == 0
+                                           ? AllocatorAlignment<typename Vec::allocator_type>::value
+                                           : 0;
+
+// Скалярные ядра; индексы отсчитываются от data, n — «не найдено»
+template <typename T>
+size_t FindScalar(const T* data, size_t n, T value) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <typename T>
+size_t CountScalar(const T* data, size_t n, T value) noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += data[i] == value ? 1 : 0;
+    }
+    return count;
+}
+
+template <typename T>
+T MinScalar(const T* data, size_t n) noexcept {
+    T result = data[0];
+    for (size_t i = 1; i < n; ++i) {
+        result = data[i] < result ? data[i] : result;
+    }
+    return result;
+}
+
+template <typename T>
+T MaxScalar(const T* data, size_t n) noexcept {
+    T result = data[0];
+    for (size_t i = 1; i < n; ++i) {
+        result = result < data[i] ? data[i] : result;
+    }
+    return result;
+}
+
+template <typename T>
+SumType<T> SumScalar(const T* data, size_t n) noexcept {
+    SumType<T> sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += static_cast<SumType<T>>(data[i]);
+    }
+    return sum;
+}
+
+template <typename T>
+SumType<T> DotScalar(const T* a, const T* b, size_t n) noexcept {
+    SumType<T> sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += static_cast<SumType<T>>(a[i]) * static_cast<SumType<T>>(b[i]);
+    }
+    return sum;
+}
+
+#if defined(VECTOR_ALGORITHMS_X86)
+
+namespace avx2 {
+
+#define VECTOR_ALGORITHMS_AVX2 __attribute__((target("avx2,fma,popcnt")))
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX2 inline __m256i Load(const int32_t* p) noexcept {
+    const auto* address = reinterpret_cast<const __m256i*>(p);
+    return kAligned ? _mm256_load_si256(address) : _mm256_loadu_si256(address);
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX2 inline __m256 Load(const float* p) noexcept {
+    return kAligned ? _mm256_load_ps(p) : _mm256_loadu_ps(p);
+}
+
+VECTOR_ALGORITHMS_AVX2 inline int EqualMask(__m256i v, __m256i needle) noexcept {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, needle)));
+}
+
+VECTOR_ALGORITHMS_AVX2 inline int EqualMask(__m256 v, __m256 needle) noexcept {
+    return _mm256_movemask_ps(_mm256_cmp_ps(v, needle, _CMP_EQ_OQ));
+}
+
+VECTOR_ALGORITHMS_AVX2 inline __m256i Broadcast(int32_t value) noexcept {
+    return _mm256_set1_epi32(value);
+}
+
+VECTOR_ALGORITHMS_AVX2 inline __m256 Broadcast(float value) noexcept {
+    return _mm256_set1_ps(value);
+}
+
+VECTOR_ALGORITHMS_AVX2 inline __m256i Min(__m256i a, __m256i b) noexcept {
+    return _mm256_min_epi32(a, b);
+}
+
+VECTOR_ALGORITHMS_AVX2 inline __m256 Min(__m256 a, __m256 b) noexcept {
+    return _mm256_min_ps(a, b);
+}
+
+VECTOR_ALGORITHMS_AVX2 inline __m256i Max(__m256i a, __m256i b) noexcept {
+    return _mm256_max_epi32(a, b);
+}
+
+VECTOR_ALGORITHMS_AVX2 inline __m256 Max(__m256 a, __m256 b) noexcept {
+    return _mm256_max_ps(a, b);
+}
+
+VECTOR_ALGORITHMS_AVX2 inline void Store(int32_t* p, __m256i v) noexcept {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+VECTOR_ALGORITHMS_AVX2 inline void Store(float* p, __m256 v) noexcept {
+    _mm256_store_ps(p, v);
+}
+
+template <bool kAligned, typename T>
+VECTOR_ALGORITHMS_AVX2 size_t Find(const T* data, size_t n, T value) noexcept {
+    const auto needle = Broadcast(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int mask = EqualMask(Load<kAligned>(data + i), needle);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+template <bool kAligned, typename T>
+VECTOR_ALGORITHMS_AVX2 size_t Count(const T* data, size_t n, T value) noexcept {
+    const auto needle = Broadcast(value);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        count += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(EqualMask(Load<kAligned>(data + i), needle))));
+    }
+    return count + CountScalar(data + i, n - i, value);
+}
+
+template <bool kAligned, bool kMin, typename T>
+VECTOR_ALGORITHMS_AVX2 T Extremum(const T* data, size_t n) noexcept {
+    if (n < 8) {
+        return kMin ? MinScalar(data, n) : MaxScalar(data, n);
+    }
+    auto acc = Load<kAligned>(data);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        acc = kMin ? Min(acc, Load<kAligned>(data + i)) : Max(acc, Load<kAligned>(data + i));
+    }
+    alignas(32) T lanes[8];
+    Store(lanes, acc);
+    T result = kMin ? MinScalar(lanes, 8) : MaxScalar(lanes, 8);
+    for (; i < n; ++i) {
+        result = kMin ? (data[i] < result ? data[i] : result) : (result < data[i] ? data[i] : result);
+    }
+    return result;
+}
+
+VECTOR_ALGORITHMS_AVX2 inline int64_t ReduceAdd(__m256i acc) noexcept {
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+VECTOR_ALGORITHMS_AVX2 inline float ReduceAdd(__m256 acc) noexcept {
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX2 int64_t Sum(const int32_t* data, size_t n) noexcept {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = Load<kAligned>(data + i);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    return ReduceAdd(acc) + SumScalar(data + i, n - i);
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX2 float Sum(const float* data, size_t n) noexcept {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_add_ps(acc, Load<kAligned>(data + i));
+    }
+    return ReduceAdd(acc) + SumScalar(data + i, n - i);
+}
+
+// Произведения 32-битных полос считаются точно в 64-битных полосах
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX2 int64_t Dot(const int32_t* a, const int32_t* b, size_t n) noexcept {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i va = Load<kAligned>(a + i);
+        const __m256i vb = Load<kAligned>(b + i);
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(va)),
+                                                     _mm256_cvtepi32_epi64(_mm256_castsi256_si128(vb))));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(va, 1)),
+                                                     _mm256_cvtepi32_epi64(_mm256_extracti128_si256(vb, 1))));
+    }
+    return ReduceAdd(acc) + DotScalar(a + i, b + i, n - i);
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX2 float Dot(const float* a, const float* b, size_t n) noexcept {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_fmadd_ps(Load<kAligned>(a + i), Load<kAligned>(b + i), acc);
+    }
+    return ReduceAdd(acc) + DotScalar(a + i, b + i, n - i);
+}
+
+#undef VECTOR_ALGORITHMS_AVX2
+
+}  // namespace avx2
+
+// Встроенные функции AVX-512 в GCC 12 дают ложные -Wuninitialized из-за _mm512_undefined_*
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// Хвост короче 16 элементов читается маскированной загрузкой, без скалярного цикла
+namespace avx512 {
+
+#define VECTOR_ALGORITHMS_AVX512 __attribute__((target("avx512f,popcnt")))
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX512 inline __m512i Load(const int32_t* p) noexcept {
+    return kAligned ? _mm512_load_si512(p) : _mm512_loadu_si512(p);
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX512 inline __m512 Load(const float* p) noexcept {
+    return kAligned ? _mm512_load_ps(p) : _mm512_loadu_ps(p);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512i LoadTail(const int32_t* p, __mmask16 k) noexcept {
+    return _mm512_maskz_loadu_epi32(k, p);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512 LoadTail(const float* p, __mmask16 k) noexcept {
+    return _mm512_maskz_loadu_ps(k, p);
+}
+
+inline __mmask16 TailMask(size_t count) noexcept {
+    return static_cast<__mmask16>((1u << count) - 1);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __mmask16 EqualMask(__mmask16 k, __m512i v, __m512i needle) noexcept {
+    return _mm512_mask_cmpeq_epi32_mask(k, v, needle);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __mmask16 EqualMask(__mmask16 k, __m512 v, __m512 needle) noexcept {
+    return _mm512_mask_cmp_ps_mask(k, v, needle, _CMP_EQ_OQ);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512i Broadcast(int32_t value) noexcept {
+    return _mm512_set1_epi32(value);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512 Broadcast(float value) noexcept {
+    return _mm512_set1_ps(value);
+}
+
+// Полосы вне маски k сохраняют значение acc
+VECTOR_ALGORITHMS_AVX512 inline __m512i Min(__m512i acc, __mmask16 k, __m512i v) noexcept {
+    return _mm512_mask_min_epi32(acc, k, acc, v);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512 Min(__m512 acc, __mmask16 k, __m512 v) noexcept {
+    return _mm512_mask_min_ps(acc, k, acc, v);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512i Max(__m512i acc, __mmask16 k, __m512i v) noexcept {
+    return _mm512_mask_max_epi32(acc, k, acc, v);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512 Max(__m512 acc, __mmask16 k, __m512 v) noexcept {
+    return _mm512_mask_max_ps(acc, k, acc, v);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline int32_t ReduceMin(__m512i v) noexcept {
+    return _mm512_reduce_min_epi32(v);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline float ReduceMin(__m512 v) noexcept {
+    return _mm512_reduce_min_ps(v);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline int32_t ReduceMax(__m512i v) noexcept {
+    return _mm512_reduce_max_epi32(v);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline float ReduceMax(__m512 v) noexcept {
+    return _mm512_reduce_max_ps(v);
+}
+
+template <bool kAligned, typename T>
+VECTOR_ALGORITHMS_AVX512 size_t Find(const T* data, size_t n, T value) noexcept {
+    const auto needle = Broadcast(value);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __mmask16 mask = EqualMask(0xFFFF, Load<kAligned>(data + i), needle);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    if (i < n) {
+        const __mmask16 k = TailMask(n - i);
+        const __mmask16 mask = EqualMask(k, LoadTail(data + i, k), needle);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    return n;
+}
+
+template <bool kAligned, typename T>
+VECTOR_ALGORITHMS_AVX512 size_t Count(const T* data, size_t n, T value) noexcept {
+    const auto needle = Broadcast(value);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        count += static_cast<size_t>(__builtin_popcount(EqualMask(0xFFFF, Load<kAligned>(data + i), needle)));
+    }
+    if (i < n) {
+        const __mmask16 k = TailMask(n - i);
+        count += static_cast<size_t>(__builtin_popcount(EqualMask(k, LoadTail(data + i, k), needle)));
+    }
+    return count;
+}
+
+template <bool kAligned, bool kMin, typename T>
+VECTOR_ALGORITHMS_AVX512 T Extremum(const T* data, size_t n) noexcept {
+    auto acc = Broadcast(data[0]);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc = kMin ? Min(acc, 0xFFFF, Load<kAligned>(data + i)) : Max(acc, 0xFFFF, Load<kAligned>(data + i));
+    }
+    if (i < n) {
+        const __mmask16 k = TailMask(n - i);
+        acc = kMin ? Min(acc, k, LoadTail(data + i, k)) : Max(acc, k, LoadTail(data + i, k));
+    }
+    return kMin ? ReduceMin(acc) : ReduceMax(acc);
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512i WidenLow(__m512i v) noexcept {
+    return _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v));
+}
+
+VECTOR_ALGORITHMS_AVX512 inline __m512i WidenHigh(__m512i v) noexcept {
+    return _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1));
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX512 int64_t Sum(const int32_t* data, size_t n) noexcept {
+    __m512i acc = _mm512_setzero_si512();
+    for (size_t i = 0; i < n; i += 16) {
+        const __m512i v = i + 16 <= n ? Load<kAligned>(data + i) : LoadTail(data + i, TailMask(n - i));
+        acc = _mm512_add_epi64(acc, _mm512_add_epi64(WidenLow(v), WidenHigh(v)));
+    }
+    return _mm512_reduce_add_epi64(acc);
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX512 float Sum(const float* data, size_t n) noexcept {
+    __m512 acc = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        acc = _mm512_add_ps(acc, i + 16 <= n ? Load<kAligned>(data + i) : LoadTail(data + i, TailMask(n - i)));
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX512 int64_t Dot(const int32_t* a, const int32_t* b, size_t n) noexcept {
+    __m512i acc = _mm512_setzero_si512();
+    for (size_t i = 0; i < n; i += 16) {
+        const bool full = i + 16 <= n;
+        const __m512i va = full ? Load<kAligned>(a + i) : LoadTail(a + i, TailMask(n - i));
+        const __m512i vb = full ? Load<kAligned>(b + i) : LoadTail(b + i, TailMask(n - i));
+        acc = _mm512_add_epi64(acc, _mm512_mul_epi32(WidenLow(va), WidenLow(vb)));
+        acc = _mm512_add_epi64(acc, _mm512_mul_epi32(WidenHigh(va), WidenHigh(vb)));
+    }
+    return _mm512_reduce_add_epi64(acc);
+}
+
+template <bool kAligned>
+VECTOR_ALGORITHMS_AVX512 float Dot(const float* a, const float* b, size_t n) noexcept {
+    __m512 acc = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        const bool full = i + 16 <= n;
+        const __m512 va = full ? Load<kAligned>(a + i) : LoadTail(a + i, TailMask(n - i));
+        const __m512 vb = full ? Load<kAligned>(b + i) : LoadTail(b + i, TailMask(n - i));
+        acc = _mm512_fmadd_ps(va, vb, acc);
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+#undef VECTOR_ALGORITHMS_AVX512
+
+}  // namespace avx512
+
+#pragma GCC diagnostic pop
+
+#endif  // VECTOR_ALGORITHMS_X86
+
+#if defined(VECTOR_ALGORITHMS_NEON)
+
+// NEON входит в базовый набор AArch64; выровненных загрузок отдельно нет
+namespace neon {
+
+inline uint32x4_t EqualMask(const int32_t* p, int32_t value) noexcept {
+    return vceqq_s32(vld1q_s32(p), vdupq_n_s32(value));
+}
+
+inline uint32x4_t EqualMask(const float* p, float value) noexcept {
+    return vceqq_f32(vld1q_f32(p), vdupq_n_f32(value));
+}
+
+template <typename T>
+size_t Find(const T* data, size_t n, T value) noexcept {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (vmaxvq_u32(EqualMask(data + i, value)) != 0) {
+            return i + FindScalar(data + i, 4, value);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+template <typename T>
+size_t Count(const T* data, size_t n, T value) noexcept {
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        count += vaddvq_u32(vshrq_n_u32(EqualMask(data + i, value), 31));
+    }
+    return count + CountScalar(data + i, n - i, value);
+}
+
+template <bool kMin>
+int32_t Extremum(const int32_t* data, size_t n) noexcept {
+    if (n < 4) {
+        return kMin ? MinScalar(data, n) : MaxScalar(data, n);
+    }
+    int32x4_t acc = vld1q_s32(data);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        acc = kMin ? vminq_s32(acc, vld1q_s32(data + i)) : vmaxq_s32(acc, vld1q_s32(data + i));
+    }
+    int32_t result = kMin ? vminvq_s32(acc) : vmaxvq_s32(acc);
+    for (; i < n; ++i) {
+        result = kMin ? (data[i] < result ? data[i] : result) : (result < data[i] ? data[i] : result);
+    }
+    return result;
+}
+
+template <bool kMin>
+float Extremum(const float* data, size_t n) noexcept {
+    if (n < 4) {
+        return kMin ? MinScalar(data, n) : MaxScalar(data, n);
+    }
+    float32x4_t acc = vld1q_f32(data);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        acc = kMin ? vminq_f32(acc, vld1q_f32(data + i)) : vmaxq_f32(acc, vld1q_f32(data + i));
+    }
+    float result = kMin ? vminvq_f32(acc) : vmaxvq_f32(acc);
+    for (; i < n; ++i) {
+        result = kMin ? (data[i] < result ? data[i] : result) : (result < data[i] ? data[i] : result);
+    }
+    return result;
+}
+
+inline int64_t Sum(const int32_t* data, size_t n) noexcept {
+    int64x2_t acc = vdupq_n_s64(0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vpadalq_s32(acc, vld1q_s32(data + i));
+    }
+    return vaddvq_s64(acc) + SumScalar(data + i, n - i);
+}
+
+inline float Sum(const float* data, size_t n) noexcept {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vaddq_f32(acc, vld1q_f32(data + i));
+    }
+    return vaddvq_f32(acc) + SumScalar(data + i, n - i);
+}
+
+inline int64_t Dot(const int32_t* a, const int32_t* b, size_t n) noexcept {
+    int64x2_t acc = vdupq_n_s64(0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const int32x4_t va = vld1q_s32(a + i);
+        const int32x4_t vb = vld1q_s32(b + i);
+        acc = vmlal_s32(acc, vget_low_s32(va), vget_low_s32(vb));
+        acc = vmlal_high_s32(acc, va, vb);
+    }
+    return vaddvq_s64(acc) + DotScalar(a + i, b + i, n - i);
+}
+
+inline float Dot(const float* a, const float* b, size_t n) noexcept {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vfmaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    return vaddvq_f32(acc) + DotScalar(a + i, b + i, n - i);
+}
+
+}  // namespace neon
+
+#endif  // VECTOR_ALGORITHMS_NEON
+
+// Диспетчеры: kAlignment — гарантированное выравнивание data (0 — неизвестно)
+template <size_t kAlignment, typename T>
+size_t Find(SimdIsa isa, const T* data, size_t n, T value) noexcept {
+    if constexpr (kVectorizable<T>) {
+        switch (isa) {
+#if defined(VECTOR_ALGORITHMS_X86)
+            case SimdIsa::kAvx512:
+                return avx512::Find<(kAlignment >= 64)>(data, n, value);
+            case SimdIsa::kAvx2:
+                return avx2::Find<(kAlignment >= 32)>(data, n, value);
+#elif defined(VECTOR_ALGORITHMS_NEON)
+            case SimdIsa::kNeon:
+                return neon::Find(data, n, value);
+#endif
+            default:
+                break;
+        }
+    }
+    return FindScalar(data, n, value);
+}
+
+template <size_t kAlignment, typename T>
+size_t Count(SimdIsa isa, const T* data, size_t n, T value) noexcept {
+    if constexpr (kVectorizable<T>) {
+        switch (isa) {
+#if defined(VECTOR_ALGORITHMS_X86)
+            case SimdIsa::kAvx512:
+                return avx512::Count<(kAlignment >= 64)>(data, n, value);
+            case SimdIsa::kAvx2:
+                return avx2::Count<(kAlignment >= 32)>(data, n, value);
+#elif defined(VECTOR_ALGORITHMS_NEON)
+            case SimdIsa::kNeon:
+                return neon::Count(data, n, value);
+#endif
+            default:
+                break;
+        }
+    }
+    return CountScalar(data, n, value);
+}
+
+// Наименьшее (kMin) или наибольшее значение непустого диапазона
+template <size_t kAlignment, bool kMin, typename T>
+T Extremum(SimdIsa isa, const T* data, size_t n) noexcept {
+    if constexpr (kVectorizable<T>) {
+        switch (isa) {
+#if defined(VECTOR_ALGORITHMS_X86)
+            case SimdIsa::kAvx512:
+                return avx512::Extremum<(kAlignment >= 64), kMin>(data, n);
+            case SimdIsa::kAvx2:
+                return avx2::Extremum<(kAlignment >= 32), kMin>(data, n);
+#elif defined(VECTOR_ALGORITHMS_NEON)
+            case SimdIsa::kNeon:
+                return neon::Extremum<kMin>(data, n);
+#endif
+            default:
+                break;
+        }
+    }
+    return kMin ? MinScalar(data, n) : MaxScalar(data, n);
+}
+
+template <size_t kAlignment, typename T>
+SumType<T> Sum(SimdIsa isa, const T* data, size_t n) noexcept {
+    if constexpr (kVectorizable<T>) {
+        switch (isa) {
+#if defined(VECTOR_ALGORITHMS_X86)
+            case SimdIsa::kAvx512:
+                return avx512::Sum<(kAlignment >= 64)>(data, n);
+            case SimdIsa::kAvx2:
+                return avx2::Sum<(kAlignment >= 32)>(data, n);
+#elif defined(VECTOR_ALGORITHMS_NEON)
+            case SimdIsa::kNeon:
+                return neon::Sum(data, n);
+#endif
+            default:
+                break;
+        }
+    }
+    return SumScalar(data, n);
+}
+
+template <size_t kAlignment, typename T>
+SumType<T> Dot(SimdIsa isa, const T* a, const T* b, size_t n) noexcept {
+    if constexpr (kVectorizable<T>) {
+        switch (isa) {
+#if defined(VECTOR_ALGORITHMS_X86)
+            case SimdIsa::kAvx512:
+                return avx512::Dot<(kAlignment >= 64)>(a, b, n);
+            case SimdIsa::kAvx2:
+                return avx2::Dot<(kAlignment >= 32)>(a, b, n);
+#elif defined(VECTOR_ALGORITHMS_NEON)
+            case SimdIsa::kNeon:
+                return neon::Dot(a, b, n);
+#endif
+            default:
+                break;
+        }
+    }
+    return DotScalar(a, b, n);
+}
+
+}  // namespace detail::simd
+
+// Первый элемент, равный value, или Data() + Size()
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+const T* Find(const Vector<T, A, G, S, Storage, C>& v, const T& value) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "Find requires an arithmetic T");
+    constexpr size_t kAlignment = detail::simd::kBufferAlignment<Vector<T, A, G, S, Storage, C>, Storage>;
+    return v.Data() + detail::simd::Find<kAlignment>(ActiveSimdIsa(), v.Data(), v.Size(), value);
+}
+
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+size_t Count(const Vector<T, A, G, S, Storage, C>& v, const T& value) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "Count requires an arithmetic T");
+    constexpr size_t kAlignment = detail::simd::kBufferAlignment<Vector<T, A, G, S, Storage, C>, Storage>;
+    return detail::simd::Count<kAlignment>(ActiveSimdIsa(), v.Data(), v.Size(), value);
+}
+
+// Первый наименьший элемент или Data() для пустого вектора
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+const T* MinElement(const Vector<T, A, G, S, Storage, C>& v) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "MinElement requires an arithmetic T");
+    if (v.Size() == 0) {
+        return v.Data();
+    }
+    constexpr size_t kAlignment = detail::simd::kBufferAlignment<Vector<T, A, G, S, Storage, C>, Storage>;
+    return Find(v, detail::simd::Extremum<kAlignment, true>(ActiveSimdIsa(), v.Data(), v.Size()));
+}
+
+// Первый наибольший элемент или Data() для пустого вектора
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+const T* MaxElement(const Vector<T, A, G, S, Storage, C>& v) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "MaxElement requires an arithmetic T");
+    if (v.Size() == 0) {
+        return v.Data();
+    }
+    constexpr size_t kAlignment = detail::simd::kBufferAlignment<Vector<T, A, G, S, Storage, C>, Storage>;
+    return Find(v, detail::simd::Extremum<kAlignment, false>(ActiveSimdIsa(), v.Data(), v.Size()));
+}
+
+// Целые суммируются в 64 битах, вещественные — в своём типе
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+detail::simd::SumType<T> Sum(const Vector<T, A, G, S, Storage, C>& v) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "Sum requires an arithmetic T");
+    constexpr size_t kAlignment = detail::simd::kBufferAlignment<Vector<T, A, G, S, Storage, C>, Storage>;
+    return detail::simd::Sum<kAlignment>(ActiveSimdIsa(), v.Data(), v.Size());
+}
+
+template <typename T, typename A1, typename G1, typename S1, typename Storage1, typename C1,
+          typename A2, typename G2, typename S2, typename Storage2, typename C2>
+detail::simd::SumType<T> Dot(const Vector<T, A1, G1, S1, Storage1, C1>& a, const Vector<T, A2, G2, S2, Storage2, C2>& b) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "Dot requires an arithmetic T");
+    assert(a.Size() == b.Size());
+    constexpr size_t kAlignment = std::min(detail::simd::kBufferAlignment<Vector<T, A1, G1, S1, Storage1, C1>, Storage1>,
+                                           detail::simd::kBufferAlignment<Vector<T, A2, G2, S2, Storage2, C2>, Storage2>);
+    return detail::simd::Dot<kAlignment>(ActiveSimdIsa(), a.Data(), b.Data(), a.Size());
+}
\ No newline at end of file
@@ -0,0 +1,338 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Двоичный формат Vector: заголовок SerializedVectorHeader и данные.
+// Побайтово копируемые T пишутся как образ буфера и читаются прямо в память вектора;
+// прочие кодируются поэлементно специализацией VectorElementCodec<T>.
+// Порядок байт не преобразуется: файл другого порядка отвергается при чтении.
+struct SerializedVectorHeader {
+    static constexpr char kMagic[4] = {'A', 'V', 'E', 'C'};
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint32_t kByteOrderMark = 0x01020304;
+    // Элементы закодированы VectorElementCodec, а не записаны образом буфера
+    static constexpr uint16_t kEncodedElements = 1;
+
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t byte_order;
+    uint32_t element_size;
+    uint32_t alignment;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t payload_bytes;
+    uint64_t checksum;
+};
+
+// Приёмник закодированных элементов
+class BinaryWriter {
+public:
+    void Write(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer_.Append(bytes, bytes + size);
+    }
+
+    template <typename U>
+    void WriteValue(const U& value) {
+        static_assert(std::is_trivially_copyable_v<U>);
+        Write(&value, sizeof(U));
+    }
+
+    const Vector<char>& Buffer() const noexcept {
+        return buffer_;
+    }
+
+private:
+    Vector<char> buffer_;
+};
+
+// Источник закодированных элементов; чтение за концом данных бросает std::runtime_error
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size) noexcept
+            : cursor_(data)
+            , end_(data + size) {
+    }
+
+    void Read(void* data, size_t size) {
+        if (static_cast<size_t>(end_ - cursor_) < size) {
+            throw std::runtime_error("ReadFrom: element data is truncated");
+        }
+        std::memcpy(data, cursor_, size);
+        cursor_ += size;
+    }
+
+    template <typename U>
+    U ReadValue() {
+        static_assert(std::is_trivially_copyable_v<U> && std::is_trivially_default_constructible_v<U>);
+        U value;
+        Read(&value, sizeof(U));
+        return value;
+    }
+
+    bool AtEnd() const noexcept {
+        return cursor_ == end_;
+    }
+
+private:
+    const char* cursor_;
+    const char* end_;
+};
+
+// Поэлементное кодирование для не побайтово копируемых T. Специализация задаёт
+// static void Write(BinaryWriter&, const T&) и static T Read(BinaryReader&).
+template <typename T>
+struct VectorElementCodec;
+
+template <>
+struct VectorElementCodec<std::string> {
+    static void Write(BinaryWriter& writer, const std::string& value) {
+        writer.WriteValue(static_cast<uint64_t>(value.size()));
+        writer.Write(value.data(), value.size());
+    }
+
+    static std::string Read(BinaryReader& reader) {
+        std::string value(static_cast<size_t>(reader.ReadValue<uint64_t>()), '\0');
+        reader.Read(value.data(), value.size());
+        return value;
+    }
+};
+
+namespace detail {
+
+inline uint64_t RotateLeft(uint64_t x, int bits) noexcept {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+// Контрольная сумма данных: обрабатывает по 8 байт за шаг, чтобы не отставать от чтения
+inline uint64_t PayloadChecksum(const void* data, size_t size) noexcept {
+    constexpr uint64_t kMul1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t kMul2 = 0xC2B2AE3D27D4EB4FULL;
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = size * kMul1;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = RotateLeft(hash ^ (word * kMul2), 31) * kMul1;
+    }
+    for (; i < size; ++i) {
+        hash = RotateLeft(hash ^ (bytes[i] * kMul2), 11) * kMul1;
+    }
+    return hash ^ (hash >> 29);
+}
+
+template <typename T>
+inline constexpr bool kSerializedAsImage = std::is_trivially_copyable_v<T>;
+
+// Данные для записи: образ буфера вектора либо закодированные элементы
+class SerializedPayload {
+public:
+    template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+    explicit SerializedPayload(const Vector<T, A, G, S, Storage, C>& v) {
+        std::memcpy(header_.magic, SerializedVectorHeader::kMagic, sizeof(header_.magic));
+        header_.version = SerializedVectorHeader::kVersion;
+        header_.byte_order = SerializedVectorHeader::kByteOrderMark;
+        header_.element_size = static_cast<uint32_t>(sizeof(T));
+        header_.alignment = static_cast<uint32_t>(alignof(T));
+        header_.count = v.Size();
+        if constexpr (kSerializedAsImage<T>) {
+            data_ = v.Data();
+            header_.payload_bytes = v.Size() * sizeof(T);
+        } else {
+            for (const T& value : v) {
+                VectorElementCodec<T>::Write(encoded_, value);
+            }
+            data_ = encoded_.Buffer().begin();
+            header_.payload_bytes = encoded_.Buffer().Size();
+            header_.flags = SerializedVectorHeader::kEncodedElements;
+        }
+        header_.checksum = PayloadChecksum(data_, header_.payload_bytes);
+    }
+
+    const SerializedVectorHeader& Header() const noexcept {
+        return header_;
+    }
+
+    const void* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Bytes() const noexcept {
+        return static_cast<size_t>(header_.payload_bytes);
+    }
+
+private:
+    SerializedVectorHeader header_{};
+    BinaryWriter encoded_;
+    const void* data_ = nullptr;
+};
+
+template <typename T>
+void CheckHeader(const SerializedVectorHeader& header) {
+    if (std::memcmp(header.magic, SerializedVectorHeader::kMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("ReadFrom: not a serialized vector");
+    }
+    if (header.version != SerializedVectorHeader::kVersion) {
+        throw std::runtime_error("ReadFrom: unsupported format version " + std::to_string(header.version));
+    }
+    if (header.byte_order != SerializedVectorHeader::kByteOrderMark) {
+        throw std::runtime_error("ReadFrom: data was written with a different byte order");
+    }
+    const bool encoded = (header.flags & SerializedVectorHeader::kEncodedElements) != 0;
+    if (header.element_size != sizeof(T) || header.alignment != alignof(T) || encoded == kSerializedAsImage<T>
+        || (!encoded && header.payload_bytes != header.count * sizeof(T))) {
+        throw std::runtime_error("ReadFrom: data holds elements of a different type");
+    }
+}
+
+// Заполняет пустой v из данных, которые source(dst, size) читает целиком или бросает исключение
+template <typename T, typename A, typename G, typename S, typename Storage, typename C, typename Source>
+void ReadPayload(const SerializedVectorHeader& header, Vector<T, A, G, S, Storage, C>& v, Source&& source) {
+    assert(v.Size() == 0);
+    CheckHeader<T>(header);
+    using Vec = Vector<T, A, G, S, Storage, C>;
+    const size_t count = static_cast<size_t>(header.count);
+
+    if constexpr (kSerializedAsImage<T> && Vec::kDefaultInitIsNoop) {
+        // Одно выделение и чтение прямо в буфер вектора
+        v.ResizeDefaultInit(count);
+        try {
+            source(v.Data(), count * sizeof(T));
+            if (PayloadChecksum(v.Data(), count * sizeof(T)) != header.checksum) {
+                throw std::runtime_error("ReadFrom: checksum mismatch");
+            }
+        } catch (...) {
+            v.Clear();
+            throw;
+        }
+    } else {
+        Vector<char> buffer;
+        buffer.ResizeDefaultInit(static_cast<size_t>(header.payload_bytes));
+        source(buffer.begin(), buffer.Size());
+        if (PayloadChecksum(buffer.begin(), buffer.Size()) != header.checksum) {
+            throw std::runtime_error("ReadFrom: checksum mismatch");
+        }
+        BinaryReader reader(buffer.begin(), buffer.Size());
+        v.Reserve(count);
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                if constexpr (kSerializedAsImage<T>) {
+                    alignas(T) unsigned char storage[sizeof(T)];
+                    reader.Read(storage, sizeof(T));
+                    v.PushBack(*reinterpret_cast<const T*>(storage));
+                } else {
+                    v.PushBack(VectorElementCodec<T>::Read(reader));
+                }
+            }
+            if (!reader.AtEnd()) {
+                throw std::runtime_error("ReadFrom: unexpected data after the last element");
+            }
+        } catch (...) {
+            v.Clear();
+            throw;
+        }
+    }
+}
+
+inline void ReadExact(int fd, void* data, size_t size) {
+    char* cursor = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t n = read(fd, cursor, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "ReadFrom: read failed");
+        }
+        if (n == 0) {
+            throw std::runtime_error("ReadFrom: unexpected end of file");
+        }
+        cursor += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+inline void ReadExact(std::istream& in, void* data, size_t size) {
+    if (!in.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("ReadFrom: unexpected end of stream");
+    }
+}
+
+}  // namespace detail
+
+// Записывает заголовок и данные одним writev (повторяя его при частичной записи)
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+void WriteTo(int fd, const Vector<T, A, G, S, Storage, C>& v) {
+    const detail::SerializedPayload payload(v);
+    iovec parts[2] = {
+            {const_cast<SerializedVectorHeader*>(&payload.Header()), sizeof(SerializedVectorHeader)},
+            {const_cast<void*>(payload.Data()), payload.Bytes()},
+    };
+    iovec* part = parts;
+    int count = 2;
+    while (count > 0) {
+        const ssize_t n = writev(fd, part, count);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "WriteTo: writev failed");
+        }
+        size_t written = static_cast<size_t>(n);
+        while (count > 0 && written >= part->iov_len) {
+            written -= part->iov_len;
+            ++part;
+            --count;
+        }
+        if (count > 0) {
+            part->iov_base = static_cast<char*>(part->iov_base) + written;
+            part->iov_len -= written;
+        }
+    }
+}
+
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+void WriteTo(std::ostream& out, const Vector<T, A, G, S, Storage, C>& v) {
+    const detail::SerializedPayload payload(v);
+    out.write(reinterpret_cast<const char*>(&payload.Header()), sizeof(SerializedVectorHeader));
+    out.write(static_cast<const char*>(payload.Data()), static_cast<std::streamsize>(payload.Bytes()));
+    if (!out) {
+        throw std::runtime_error("WriteTo: stream write failed");
+    }
+}
+
+// Заменяет содержимое v прочитанным; при любой ошибке, в том числе в заголовке,
+// бросает исключение и оставляет v пустым
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+void ReadFrom(int fd, Vector<T, A, G, S, Storage, C>& v) {
+    v.Clear();
+    SerializedVectorHeader header;
+    detail::ReadExact(fd, &header, sizeof(header));
+    detail::ReadPayload(header, v, [fd](void* data, size_t size) {
+        detail::ReadExact(fd, data, size);
+    });
+}
+
+template <typename T, typename A, typename G, typename S, typename Storage, typename C>
+void ReadFrom(std::istream& in, Vector<T, A, G, S, Storage, C>& v) {
+    v.Clear();
+    SerializedVectorHeader header;
+    detail::ReadExact(in, &header, sizeof(header));
+    detail::ReadPayload(header, v, [&in](void* data, size_t size) {
+        detail::ReadExact(in, data, size);
+    });
+}
\ No newline at end of file
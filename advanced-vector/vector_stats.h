@@ -0,0 +1,187 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Моментальный снимок счётчиков одной группы векторов
+struct VectorStatsSnapshot {
+    const char* name = "";
+    uint64_t allocations = 0;
+    uint64_t reallocations = 0;
+    uint64_t in_place_reallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t elements_moved = 0;
+    uint64_t elements_copied = 0;
+    uint64_t elements_relocated_bitwise = 0;
+    uint64_t peak_capacity_bytes = 0;
+    // Сумма неиспользованного резерва новых буферов в момент перевыделения
+    uint64_t slack_bytes = 0;
+};
+
+// Счётчики группы; обновляются атомарно без блокировок
+class VectorStatsCounters {
+public:
+    explicit VectorStatsCounters(const char* name) noexcept
+            : name_(name) {
+    }
+
+    void OnAllocate(size_t capacity, size_t element_size) noexcept {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated_.fetch_add(capacity * element_size, std::memory_order_relaxed);
+        UpdatePeak(capacity * element_size);
+    }
+
+    void OnReallocate(const ReallocationEvent& event) noexcept {
+        reallocations_.fetch_add(1, std::memory_order_relaxed);
+        if (event.in_place) {
+            in_place_reallocations_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            bytes_allocated_.fetch_add(event.new_capacity * event.element_size, std::memory_order_relaxed);
+        }
+        elements_moved_.fetch_add(event.elements_moved, std::memory_order_relaxed);
+        elements_copied_.fetch_add(event.elements_copied, std::memory_order_relaxed);
+        elements_relocated_bitwise_.fetch_add(event.elements_relocated_bitwise, std::memory_order_relaxed);
+        slack_bytes_.fetch_add((event.new_capacity - event.required) * event.element_size, std::memory_order_relaxed);
+        UpdatePeak(event.new_capacity * event.element_size);
+    }
+
+    VectorStatsSnapshot Load() const noexcept {
+        VectorStatsSnapshot snapshot;
+        snapshot.name = name_;
+        snapshot.allocations = allocations_.load(std::memory_order_relaxed);
+        snapshot.reallocations = reallocations_.load(std::memory_order_relaxed);
+        snapshot.in_place_reallocations = in_place_reallocations_.load(std::memory_order_relaxed);
+        snapshot.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+        snapshot.elements_moved = elements_moved_.load(std::memory_order_relaxed);
+        snapshot.elements_copied = elements_copied_.load(std::memory_order_relaxed);
+        snapshot.elements_relocated_bitwise = elements_relocated_bitwise_.load(std::memory_order_relaxed);
+        snapshot.peak_capacity_bytes = peak_capacity_bytes_.load(std::memory_order_relaxed);
+        snapshot.slack_bytes = slack_bytes_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    void Reset() noexcept {
+        for (auto* counter : {&allocations_, &reallocations_, &in_place_reallocations_, &bytes_allocated_,
+                              &elements_moved_, &elements_copied_, &elements_relocated_bitwise_,
+                              &peak_capacity_bytes_, &slack_bytes_}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    void UpdatePeak(uint64_t bytes) noexcept {
+        uint64_t peak = peak_capacity_bytes_.load(std::memory_order_relaxed);
+        while (peak < bytes && !peak_capacity_bytes_.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+        }
+    }
+
+    const char* name_;
+    std::atomic<uint64_t> allocations_{0};
+    std::atomic<uint64_t> reallocations_{0};
+    std::atomic<uint64_t> in_place_reallocations_{0};
+    std::atomic<uint64_t> bytes_allocated_{0};
+    std::atomic<uint64_t> elements_moved_{0};
+    std::atomic<uint64_t> elements_copied_{0};
+    std::atomic<uint64_t> elements_relocated_bitwise_{0};
+    std::atomic<uint64_t> peak_capacity_bytes_{0};
+    std::atomic<uint64_t> slack_bytes_{0};
+};
+
+// Глобальный реестр групп: группа регистрируется при первом использовании своей политики
+class VectorStatsRegistry {
+public:
+    static VectorStatsRegistry& Instance() {
+        static VectorStatsRegistry registry;
+        return registry;
+    }
+
+    void Register(VectorStatsCounters* counters) {
+        std::lock_guard lock(mutex_);
+        groups_.push_back(counters);
+    }
+
+    std::vector<VectorStatsSnapshot> Collect() const {
+        std::lock_guard lock(mutex_);
+        std::vector<VectorStatsSnapshot> result;
+        result.reserve(groups_.size());
+        for (const auto* counters : groups_) {
+            result.push_back(counters->Load());
+        }
+        return result;
+    }
+
+    void Reset() {
+        std::lock_guard lock(mutex_);
+        for (auto* counters : groups_) {
+            counters->Reset();
+        }
+    }
+
+    // Выводит счётчики в текстовом формате Prometheus
+    void Dump(std::ostream& out) const {
+        for (const auto& s : Collect()) {
+            DumpCounter(out, "allocations", s.name, s.allocations);
+            DumpCounter(out, "reallocations", s.name, s.reallocations);
+            DumpCounter(out, "in_place_reallocations", s.name, s.in_place_reallocations);
+            DumpCounter(out, "bytes_allocated", s.name, s.bytes_allocated);
+            DumpCounter(out, "elements_moved", s.name, s.elements_moved);
+            DumpCounter(out, "elements_copied", s.name, s.elements_copied);
+            DumpCounter(out, "elements_relocated_bitwise", s.name, s.elements_relocated_bitwise);
+            DumpCounter(out, "peak_capacity_bytes", s.name, s.peak_capacity_bytes);
+            DumpCounter(out, "slack_bytes", s.name, s.slack_bytes);
+        }
+    }
+
+private:
+    VectorStatsRegistry() = default;
+
+    static void DumpCounter(std::ostream& out, const char* counter, const char* name, uint64_t value) {
+        out << "vector_" << counter << "{name=\"" << name << "\"} " << value << '\n';
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<VectorStatsCounters*> groups_;
+};
+
+struct DefaultStatsTag {
+    static constexpr const char* kName = "vector";
+};
+
+// Политика статистики Vector: все векторы с одним Tag пишут в общую группу Tag::kName.
+// Помечая векторы разными тегами, можно найти места, которым не хватает Reserve.
+template <typename Tag = DefaultStatsTag>
+struct VectorStats {
+    static constexpr bool kEnabled = true;
+
+    static VectorStatsCounters& Counters() noexcept {
+        static VectorStatsCounters& counters = Registered();
+        return counters;
+    }
+
+    static void OnAllocate(size_t capacity, size_t element_size) noexcept {
+        if (capacity != 0) {
+            Counters().OnAllocate(capacity, element_size);
+        }
+    }
+
+    static void OnReallocate(const ReallocationEvent& event) noexcept {
+        Counters().OnReallocate(event);
+    }
+
+private:
+    // Вызывается из noexcept-хуков, поэтому ошибка регистрации (bad_alloc в реестре)
+    // не выпускается наружу: группа продолжает считать, но не попадает в Collect и Dump
+    static VectorStatsCounters& Registered() noexcept {
+        static VectorStatsCounters counters(Tag::kName);
+        try {
+            VectorStatsRegistry::Instance().Register(&counters);
+        } catch (...) {
+        }
+        return counters;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+
+// Глобальный наблюдатель перевыделений. Вызывается в потоке, который перевыделяет вектор,
+// сразу после перевыделения и не должен бросать исключения
+using ReallocationObserver = void (*)(const ReallocationEvent& event);
+
+namespace detail {
+
+struct ReallocationObserverSlot {
+    std::atomic<ReallocationObserver> observer{nullptr};
+    std::atomic<uint64_t> min_elapsed_ns{0};
+
+    static ReallocationObserverSlot& Instance() noexcept {
+        static ReallocationObserverSlot slot;
+        return slot;
+    }
+};
+
+}  // namespace detail
+
+// Устанавливает наблюдателя (nullptr — отключает) для перевыделений не короче min_elapsed_ns
+inline void SetReallocationObserver(ReallocationObserver observer, uint64_t min_elapsed_ns = 0) noexcept {
+    auto& slot = detail::ReallocationObserverSlot::Instance();
+    slot.min_elapsed_ns.store(min_elapsed_ns, std::memory_order_relaxed);
+    slot.observer.store(observer, std::memory_order_release);
+}
+
+// Готовый наблюдатель: одна строка в stderr на перевыделение
+inline void LogReallocation(const ReallocationEvent& event) noexcept {
+    const CallSite& site = event.call_site;
+    std::fprintf(stderr,
+                 "vector reallocation: %" PRIu64 " us, capacity %zu -> %zu x %zu B, %zu B moved%s at %s:%u (%s)\n",
+                 event.elapsed_ns / 1000, event.old_capacity, event.new_capacity, event.element_size,
+                 event.bytes_moved, event.in_place ? " in place" : "",
+                 site.file != nullptr ? site.file : "?", site.line,
+                 site.function != nullptr ? site.function : "?");
+}
+
+// Политика статистики Vector, передающая каждое перевыделение наблюдателю из
+// SetReallocationObserver. Next получает те же события раньше, например VectorStats<Tag>:
+//   Vector<Order, std::allocator<Order>, DoublingGrowth, TracedStats<VectorStats<OrdersTag>>> orders;
+//   SetReallocationObserver(LogReallocation, 1'000'000);  // перевыделения дольше 1 мс
+// Без наблюдателя остаются замер времени и одна атомарная загрузка на перевыделение.
+template <typename Next = NoStats>
+struct TracedStats : Next {
+    static constexpr bool kEnabled = true;
+
+    static void OnReallocate(const ReallocationEvent& event) noexcept {
+        Next::OnReallocate(event);
+        auto& slot = detail::ReallocationObserverSlot::Instance();
+        const ReallocationObserver observer = slot.observer.load(std::memory_order_acquire);
+        if (observer != nullptr && event.elapsed_ns >= slot.min_elapsed_ns.load(std::memory_order_relaxed)) {
+            observer(event);
+        }
+    }
+};